@@ -0,0 +1,126 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#include "jet_defs.h"
+#include "io.hpp"
+#include "jet.h"
+#include "jet_config.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace jet_partitioner;
+
+//reads one graph file name per line, skipping blank lines
+bool load_graph_list(std::vector<std::string>& names, const char* list_f){
+    std::ifstream f(list_f);
+    if(!f.is_open()){
+        std::cerr << "FATAL ERROR: Could not open graph list file " << list_f << std::endl;
+        return false;
+    }
+    std::string line;
+    while(std::getline(f, line)){
+        if(!line.empty()) names.push_back(line);
+    }
+    return true;
+}
+
+int run(const std::vector<std::string>& names, const config_t& config, int instances){
+    std::vector<matrix_t> graphs;
+    std::vector<wgt_vt> vweights;
+    std::vector<bool> uniform_ew;
+    for(const std::string& name : names){
+        //batches are meant for many small graphs, so only the 32-bit types are supported
+        graph_size size = graph_size::standard;
+        if(!probe_graph_size(name.c_str(), size)) return -1;
+        if(size != graph_size::standard){
+            std::cerr << "FATAL ERROR: " << name << " needs 64-bit graph types, which batches do not support" << std::endl;
+            return -1;
+        }
+        matrix_t g;
+        wgt_vt w;
+        bool uniform = false;
+        if(!load_graph(g, w, uniform, name.c_str())) return -1;
+        graphs.push_back(g);
+        vweights.push_back(w);
+        uniform_ew.push_back(uniform);
+    }
+    std::vector<value_t> cuts;
+    double seconds = 0;
+#ifdef HOST
+    partition_host_batch(cuts, config, graphs, vweights, uniform_ew, instances, seconds);
+#elif defined SERIAL
+    partition_serial_batch(cuts, config, graphs, vweights, uniform_ew, instances, seconds);
+#else
+    partition_batch(cuts, config, graphs, vweights, uniform_ew, instances, seconds);
+#endif
+    int64_t total = 0;
+    for(value_t cut : cuts){
+        total += cut;
+    }
+    std::cout << "graphs: " << graphs.size() << "; total edgecut: " << total << std::endl;
+    std::cout << "batch time: " << seconds << " seconds; throughput: " << graphs.size() / seconds << " graphs/second" << std::endl;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+
+    if (argc < 3) {
+        std::cerr << "Insufficient number of args provided" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <graph_list_file> <config_file> <optional instance_count>" << std::endl;
+        return -1;
+    }
+    config_t config;
+    std::vector<std::string> names;
+    if(!load_graph_list(names, argv[1])) return -1;
+    if(!load_config(config, argv[2])) return -1;
+    int instances = 0;
+    if(argc >= 4){
+        instances = atoi(argv[3]);
+    }
+    config.verbose = false;
+    if(getenv("JET_SEED") != nullptr) config.seed = strtoull(getenv("JET_SEED"), nullptr, 10);
+
+    Kokkos::initialize();
+    //must scope kokkos-related data
+    //so that it falls out of scope b4 finalize
+    int ret = run(names, config, instances);
+    Kokkos::finalize();
+
+    return ret;
+}
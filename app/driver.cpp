@@ -44,6 +44,8 @@
 #include <limits>
 #include <vector>
 #include <algorithm>
+#include <thread>
+#include <chrono>
 
 using namespace jet_partitioner;
 
@@ -53,7 +55,8 @@ void degree_weighting(const matrix_t& g, wgt_vt vweights){
     });
 }
 
-value_t median(std::vector<value_t>& cuts){
+template<typename scalar_t>
+scalar_t median(std::vector<scalar_t>& cuts){
     std::sort(cuts.begin(), cuts.end());
     int count = cuts.size();
     if(count % 2 == 0){
@@ -63,11 +66,258 @@ value_t median(std::vector<value_t>& cuts){
     }
 }
 
+//warm starts refine in place, so every attempt gets its own copy of the initial partition
+part_vt warm_start_copy(const part_vt& initial, const Device& exec){
+    part_vt part(Kokkos::ViewAllocateWithoutInitializing("warm start partition"), initial.extent(0));
+    Kokkos::deep_copy(exec, part, initial);
+    return part;
+}
+
+//selects the library entry point matching the graph types and build target
+//a non-empty initial partition is refined instead of partitioning from scratch
+part_vt run_partition(value_t& edgecut, const config_t& config, const matrix_t& g, const wgt_vt& vweights,
+    bool uniform_ew, experiment_data<value_t>& experiment, const Device& exec, context& ctx, const part_vt& initial){
+    if(initial.extent(0) > 0){
+        part_vt part = warm_start_copy(initial, exec);
+#ifdef HOST
+        return refine_host(edgecut, config, g, vweights, uniform_ew, part, experiment, exec, &ctx);
+#elif defined SERIAL
+        return refine_serial(edgecut, config, g, vweights, uniform_ew, part, experiment, exec, &ctx);
+#else
+        return refine(edgecut, config, g, vweights, uniform_ew, part, experiment, exec, &ctx);
+#endif
+    }
+#ifdef HOST
+    return partition_host(edgecut, config, g, vweights, uniform_ew, experiment, exec, &ctx);
+#elif defined SERIAL
+    return partition_serial(edgecut, config, g, vweights, uniform_ew, experiment, exec, &ctx);
+#else
+    return partition(edgecut, config, g, vweights, uniform_ew, experiment, exec, &ctx);
+#endif
+}
+
+part_vt run_partition(big_val_t& edgecut, const config_t& config, const big_matrix_t& g, const big_wgt_vt& vweights,
+    bool uniform_ew, experiment_data<big_val_t>& experiment, const Device& exec, context& ctx, const part_vt& initial){
+    if(initial.extent(0) > 0){
+        part_vt part = warm_start_copy(initial, exec);
+#ifdef HOST
+        return refine_host_big(edgecut, config, g, vweights, uniform_ew, part, experiment, exec, &ctx);
+#elif defined SERIAL
+        return refine_serial_big(edgecut, config, g, vweights, uniform_ew, part, experiment, exec, &ctx);
+#else
+        return refine_big(edgecut, config, g, vweights, uniform_ew, part, experiment, exec, &ctx);
+#endif
+    }
+#ifdef HOST
+    return partition_host_big(edgecut, config, g, vweights, uniform_ew, experiment, exec, &ctx);
+#elif defined SERIAL
+    return partition_serial_big(edgecut, config, g, vweights, uniform_ew, experiment, exec, &ctx);
+#else
+    return partition_big(edgecut, config, g, vweights, uniform_ew, experiment, exec, &ctx);
+#endif
+}
+
+part_vt run_partition(big_val_t& edgecut, const config_t& config, const biggest_matrix_t& g, const big_wgt_vt& vweights,
+    bool uniform_ew, experiment_data<big_val_t>& experiment, const Device& exec, context& ctx, const part_vt& initial){
+    if(initial.extent(0) > 0){
+        part_vt part = warm_start_copy(initial, exec);
+#ifdef HOST
+        return refine_host_biggest(edgecut, config, g, vweights, uniform_ew, part, experiment, exec, &ctx);
+#elif defined SERIAL
+        return refine_serial_biggest(edgecut, config, g, vweights, uniform_ew, part, experiment, exec, &ctx);
+#else
+        return refine_biggest(edgecut, config, g, vweights, uniform_ew, part, experiment, exec, &ctx);
+#endif
+    }
+#ifdef HOST
+    return partition_host_biggest(edgecut, config, g, vweights, uniform_ew, experiment, exec, &ctx);
+#elif defined SERIAL
+    return partition_serial_biggest(edgecut, config, g, vweights, uniform_ew, experiment, exec, &ctx);
+#else
+    return partition_biggest(edgecut, config, g, vweights, uniform_ew, experiment, exec, &ctx);
+#endif
+}
+
+//sweep counterparts of run_partition
+std::vector<part_vt> run_sweep(std::vector<value_t>& edgecuts, const config_t& config, const std::vector<part_t>& part_counts,
+    const matrix_t& g, const wgt_vt& vweights, bool uniform_ew, std::vector<experiment_data<value_t>>& experiments){
+#ifdef HOST
+    auto parts = partition_host_sweep(edgecuts, config, part_counts, g, vweights, uniform_ew, experiments);
+    return std::vector<part_vt>(parts.begin(), parts.end());
+#elif defined SERIAL
+    auto parts = partition_serial_sweep(edgecuts, config, part_counts, g, vweights, uniform_ew, experiments);
+    return std::vector<part_vt>(parts.begin(), parts.end());
+#else
+    auto parts = partition_sweep(edgecuts, config, part_counts, g, vweights, uniform_ew, experiments);
+    return std::vector<part_vt>(parts.begin(), parts.end());
+#endif
+}
+
+std::vector<part_vt> run_sweep(std::vector<big_val_t>& edgecuts, const config_t& config, const std::vector<part_t>& part_counts,
+    const big_matrix_t& g, const big_wgt_vt& vweights, bool uniform_ew, std::vector<experiment_data<big_val_t>>& experiments){
+#ifdef HOST
+    auto parts = partition_host_big_sweep(edgecuts, config, part_counts, g, vweights, uniform_ew, experiments);
+    return std::vector<part_vt>(parts.begin(), parts.end());
+#elif defined SERIAL
+    auto parts = partition_serial_big_sweep(edgecuts, config, part_counts, g, vweights, uniform_ew, experiments);
+    return std::vector<part_vt>(parts.begin(), parts.end());
+#else
+    auto parts = partition_big_sweep(edgecuts, config, part_counts, g, vweights, uniform_ew, experiments);
+    return std::vector<part_vt>(parts.begin(), parts.end());
+#endif
+}
+
+std::vector<part_vt> run_sweep(std::vector<big_val_t>& edgecuts, const config_t& config, const std::vector<part_t>& part_counts,
+    const biggest_matrix_t& g, const big_wgt_vt& vweights, bool uniform_ew, std::vector<experiment_data<big_val_t>>& experiments){
+#ifdef HOST
+    auto parts = partition_host_biggest_sweep(edgecuts, config, part_counts, g, vweights, uniform_ew, experiments);
+    return std::vector<part_vt>(parts.begin(), parts.end());
+#elif defined SERIAL
+    auto parts = partition_serial_biggest_sweep(edgecuts, config, part_counts, g, vweights, uniform_ew, experiments);
+    return std::vector<part_vt>(parts.begin(), parts.end());
+#else
+    auto parts = partition_biggest_sweep(edgecuts, config, part_counts, g, vweights, uniform_ew, experiments);
+    return std::vector<part_vt>(parts.begin(), parts.end());
+#endif
+}
+
+//parses a comma separated list of part counts
+bool parse_part_counts(std::vector<part_t>& part_counts, const char* list){
+    const char* p = list;
+    while(*p != '\0'){
+        char* end = nullptr;
+        long k = strtol(p, &end, 10);
+        if(end == p || k < 2 || k > std::numeric_limits<part_t>::max() || (*end != ',' && *end != '\0')){
+            std::cerr << "FATAL ERROR: Invalid part count list \"" << list << "\"" << std::endl;
+            return false;
+        }
+        part_counts.push_back(k);
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return true;
+}
+
+//inserts the part count before a ".bin" suffix, so that binary output stays binary
+std::string sweep_part_file(const char* part_file, part_t k){
+    std::string name = part_file;
+    std::string tag = "_k" + std::to_string(k);
+    if(is_binary_part_name(part_file)){
+        return name.substr(0, name.size() - 4) + tag + ".bin";
+    }
+    return name + tag;
+}
+
+//partitions the graph once for every part count, coarsening only once
+template<class crsMat>
+int sweep(const char* filename, const config_t& config, const std::vector<part_t>& part_counts, const char* part_file, const char* metrics){
+    using scalar_t = typename crsMat::value_type;
+    using wgt_view_t = Kokkos::View<scalar_t*, Device>;
+    crsMat g;
+    wgt_view_t vweights;
+    bool uniform_ew = false;
+    if(!load_graph(g, vweights, uniform_ew, filename)) return -1;
+    std::cout << "vertices: " << g.numRows() << "; edges: " << g.nnz() / 2 << std::endl;
+
+    std::vector<scalar_t> cuts;
+    std::vector<experiment_data<scalar_t>> experiments;
+    Kokkos::Timer t;
+    std::vector<part_vt> parts = run_sweep(cuts, config, part_counts, g, vweights, uniform_ew, experiments);
+    Kokkos::fence();
+    double sweep_time = t.seconds();
+    for(size_t i = 0; i < part_counts.size(); i++){
+        std::cout << "graph " << filename << ", k = " << part_counts[i] << ", edgecut: " << cuts[i] << std::endl;
+        if(metrics != nullptr) experiments[i].log(metrics, i == 0, i + 1 == part_counts.size());
+        if(part_file != nullptr) write_part(parts[i], sweep_part_file(part_file, part_counts[i]).c_str());
+    }
+    std::cout << "sweep time: " << sweep_time << " seconds" << std::endl;
+    return 0;
+}
+
+template<class crsMat>
+int run(const char* filename, const config_t& config, int concurrent, const char* part_file, const char* metrics, const char* initial_file, double time_limit){
+    using scalar_t = typename crsMat::value_type;
+    using wgt_view_t = Kokkos::View<scalar_t*, Device>;
+    crsMat g;
+    wgt_view_t vweights;
+    bool uniform_ew = false;
+    if(!load_graph(g, vweights, uniform_ew, filename)) return -1;
+    std::cout << "vertices: " << g.numRows() << "; edges: " << g.nnz() / 2 << std::endl;
+    part_vt initial;
+    if(initial_file != nullptr && !load_part(initial, g.numRows(), config.num_parts, initial_file)) return -1;
+
+    //concurrent attempts each run on their own instance of the execution space
+    std::vector<Device> instances = {Device()};
+    concurrent = std::min(concurrent, config.num_iter);
+    if(concurrent > 1){
+        instances = Kokkos::Experimental::partition_space(Device(), std::vector<int>(concurrent, 1));
+    }
+
+    //attempts on the same instance reuse scratch memory through a shared context
+    std::vector<context> contexts(instances.size());
+
+    part_vt best_part;
+
+    scalar_t edgecut_min = std::numeric_limits<scalar_t>::max();
+    std::vector<scalar_t> cuts;
+    int64_t avg = 0;
+    for (int i=0; i < config.num_iter; i += instances.size()) {
+        Kokkos::fence();
+        int batch = std::min<int>(instances.size(), config.num_iter - i);
+        std::vector<scalar_t> batch_cuts(batch, 0);
+        std::vector<part_vt> batch_parts(batch);
+        std::vector<experiment_data<scalar_t>> batch_experiments(batch);
+        auto attempt = [&](int j){
+            config_t attempt_config = config;
+            if(time_limit > 0){
+                attempt_config.deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(time_limit));
+            }
+            batch_parts[j] = run_partition(batch_cuts[j], attempt_config, g, vweights, uniform_ew, batch_experiments[j], instances[j], contexts[j], initial);
+            instances[j].fence();
+        };
+        if(batch == 1){
+            attempt(0);
+        } else {
+            std::vector<std::thread> threads;
+            for (int j=0; j < batch; j++) {
+                threads.emplace_back(attempt, j);
+            }
+            for (std::thread& t : threads) {
+                t.join();
+            }
+        }
+        for (int j=0; j < batch; j++) {
+            scalar_t edgecut = batch_cuts[j];
+            if(batch_experiments[j].isTruncated()) std::cout << "attempt " << (i + j) << " reached the time limit" << std::endl;
+            avg += edgecut;
+            cuts.push_back(edgecut);
+
+            if (edgecut < edgecut_min) {
+                edgecut_min = edgecut;
+                best_part = batch_parts[j];
+            }
+            bool first = true, last = true;
+            if (i + j > 0) {
+                first = false;
+            }
+            if (i + j + 1 < config.num_iter) {
+                last = false;
+            }
+            if(metrics != nullptr) batch_experiments[j].log(metrics, first, last);
+        }
+    }
+    std::cout << "graph " << filename << ", min edgecut found is " << edgecut_min << std::endl;
+    std::cout << "average edgecut: " << (avg / config.num_iter) << std::endl;
+    std::cout << "median edgecut: " << median(cuts) << std::endl;
+
+    if(part_file != nullptr && config.num_iter > 0) write_part(best_part, part_file);
+    return 0;
+}
+
 int main(int argc, char **argv) {
 
     if (argc < 3) {
         std::cerr << "Insufficient number of args provided" << std::endl;
-        std::cerr << "Usage: " << argv[0] << " <metis_graph_file> <config_file> <optional partition_output_filename> <optional metrics_filename>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <graph_file> <config_file> <optional partition_output_filename> <optional metrics_filename>" << std::endl;
         return -1;
     }
     config_t config;
@@ -81,69 +331,51 @@ int main(int argc, char **argv) {
     if(argc >= 5){
         metrics = argv[4];
     }
-#ifdef FOUR9
-    config.refine_tolerance = 0.9999;
-#elif defined TWO9
-    config.refine_tolerance = 0.99;
-#endif
 #ifdef EXP
     config.dump_coarse = true;
+    config.coarse_dump_file = coarse_hierarchy_file();
 #endif
     config.verbose = true;
+    //opt-in coarse hierarchy cache and fixed coarsening seed
+    config.hierarchy_cache_dir = getenv("JET_HIERARCHY_CACHE");
+    if(getenv("JET_SEED") != nullptr) config.seed = strtoull(getenv("JET_SEED"), nullptr, 10);
+    //number of attempts run at once, each on a separate partition of the execution space
+    int concurrent = 1;
+    if(getenv("JET_CONCURRENT_ATTEMPTS") != nullptr) concurrent = std::max(1, atoi(getenv("JET_CONCURRENT_ATTEMPTS")));
+    //every attempt would write the same hierarchy file
+    if(config.dump_coarse) concurrent = 1;
+    //refines this partition instead of partitioning from scratch
+    const char* initial_file = getenv("JET_INITIAL_PART");
+    //seconds per attempt after which refinement only rebalances and returns
+    double time_limit = 0;
+    if(getenv("JET_TIME_LIMIT") != nullptr) time_limit = atof(getenv("JET_TIME_LIMIT"));
+    //partitions for several part counts from one coarse hierarchy instead of num_iter attempts
+    std::vector<part_t> part_counts;
+    if(getenv("JET_SWEEP_PARTS") != nullptr && !parse_part_counts(part_counts, getenv("JET_SWEEP_PARTS"))) return -1;
+    //graphs too large for 32-bit offsets or ids are loaded into the 64-bit types
+    graph_size size = graph_size::standard;
+    if(!probe_graph_size(filename, size)) return -1;
 
     Kokkos::initialize();
     //must scope kokkos-related data
     //so that it falls out of scope b4 finalize
-    {
-        matrix_t g;
-        bool uniform_ew = false;
-        if(!load_metis_graph(g, uniform_ew, filename)) return -1;
-        std::cout << "vertices: " << g.numRows() << "; edges: " << g.nnz() / 2 << std::endl;
-        wgt_vt vweights("vertex weights", g.numRows());
-        Kokkos::deep_copy(vweights, 1);
-
-        part_vt best_part;
-
-        value_t edgecut_min = std::numeric_limits<value_t>::max();
-        std::vector<value_t> cuts;
-        int64_t avg = 0;
-        for (int i=0; i < config.num_iter; i++) {
-            Kokkos::fence();
-            value_t edgecut = 0;
-            experiment_data<value_t> experiment;
-#ifdef HOST
-            part_vt part = partition_host(edgecut, config, g, vweights, uniform_ew,
-                experiment);
-#elif defined SERIAL
-            part_vt part = partition_serial(edgecut, config, g, vweights, uniform_ew,
-                experiment);
-#else
-            part_vt part = partition(edgecut, config, g, vweights, uniform_ew,
-                experiment);
-#endif
-            avg += edgecut;
-            cuts.push_back(edgecut);
-
-            if (edgecut < edgecut_min) {
-                edgecut_min = edgecut;
-                best_part = part;
-            }
-            bool first = true, last = true;
-            if (i > 0) {
-                first = false;
-            }
-            if (i + 1 < config.num_iter) {
-                last = false;
-            }
-            if(metrics != nullptr) experiment.log(metrics, first, last);
+    int ret = 0;
+    if(!part_counts.empty()){
+        if(size == graph_size::biggest){
+            ret = sweep<biggest_matrix_t>(filename, config, part_counts, part_file, metrics);
+        } else if(size == graph_size::big){
+            ret = sweep<big_matrix_t>(filename, config, part_counts, part_file, metrics);
+        } else {
+            ret = sweep<matrix_t>(filename, config, part_counts, part_file, metrics);
         }
-        std::cout << "graph " << filename << ", min edgecut found is " << edgecut_min << std::endl;
-        std::cout << "average edgecut: " << (avg / config.num_iter) << std::endl;
-        std::cout << "median edgecut: " << median(cuts) << std::endl;
-
-        if(part_file != nullptr && config.num_iter > 0) write_part(best_part, part_file);
+    } else if(size == graph_size::biggest){
+        ret = run<biggest_matrix_t>(filename, config, concurrent, part_file, metrics, initial_file, time_limit);
+    } else if(size == graph_size::big){
+        ret = run<big_matrix_t>(filename, config, concurrent, part_file, metrics, initial_file, time_limit);
+    } else {
+        ret = run<matrix_t>(filename, config, concurrent, part_file, metrics, initial_file, time_limit);
     }
     Kokkos::finalize();
 
-    return 0;
+    return ret;
 }
@@ -0,0 +1,183 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#include "jet_defs.h"
+#include "io.hpp"
+#include "jet.h"
+#include "jet_config.h"
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace jet_partitioner;
+
+//copies a host vector into a new device view
+template<class view_t, typename T>
+view_t to_device(const std::vector<T>& x, const char* label){
+    view_t v(label, x.size());
+    auto v_m = Kokkos::create_mirror_view(v);
+    for(size_t i = 0; i < x.size(); i++){
+        v_m(i) = x[i];
+    }
+    Kokkos::deep_copy(v, v_m);
+    return v;
+}
+
+//a random batch of about size changes to the current graph: deletions of existing edges, insertions,
+//new vertices connected to existing ones, and vertex weight changes
+graph_update random_batch(const matrix_t& g, ordinal_t size, std::mt19937& rng){
+    auto row_map = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), g.graph.row_map);
+    auto entries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), g.graph.entries);
+    ordinal_t n = g.numRows();
+    ordinal_t added = std::max(size / 8, 1);
+    ordinal_t total = n + added;
+    std::uniform_int_distribution<ordinal_t> old_vtx(0, n - 1), any_vtx(0, total - 1);
+    std::uniform_int_distribution<value_t> wgt(1, 3);
+    //each deleted edge is listed once
+    std::set<std::pair<ordinal_t, ordinal_t>> deleted;
+    for(ordinal_t x = 0; x < size / 2; x++){
+        ordinal_t u = old_vtx(rng);
+        edge_offset_t degree = row_map(u + 1) - row_map(u);
+        if(degree == 0) continue;
+        ordinal_t v = entries(row_map(u) + std::uniform_int_distribution<edge_offset_t>(0, degree - 1)(rng));
+        deleted.emplace(std::min(u, v), std::max(u, v));
+    }
+    std::vector<ordinal_t> del_src, del_dst, ins_src, ins_dst, weight_vtx;
+    std::vector<value_t> ins_wgt, weight_val;
+    for(const auto& e : deleted){
+        del_src.push_back(e.first);
+        del_dst.push_back(e.second);
+    }
+    //inserted edges may repeat existing ones, which adds to their weight
+    for(ordinal_t x = 0; x < size; x++){
+        ins_src.push_back(any_vtx(rng));
+        ins_dst.push_back(any_vtx(rng));
+        ins_wgt.push_back(wgt(rng));
+    }
+    for(ordinal_t i = n; i < total; i++){
+        ins_src.push_back(i);
+        ins_dst.push_back(old_vtx(rng));
+        ins_wgt.push_back(wgt(rng));
+    }
+    std::set<ordinal_t> reweighted;
+    for(ordinal_t x = 0; x < added; x++){
+        reweighted.insert(any_vtx(rng));
+    }
+    for(ordinal_t v : reweighted){
+        weight_vtx.push_back(v);
+        weight_val.push_back(wgt(rng) + 1);
+    }
+    graph_update update;
+    update.insert_src = to_device<vtx_vt>(ins_src, "insert src");
+    update.insert_dst = to_device<vtx_vt>(ins_dst, "insert dst");
+    update.insert_wgt = to_device<wgt_vt>(ins_wgt, "insert wgt");
+    update.delete_src = to_device<vtx_vt>(del_src, "delete src");
+    update.delete_dst = to_device<vtx_vt>(del_dst, "delete dst");
+    update.weight_vertices = to_device<vtx_vt>(weight_vtx, "weight vertices");
+    update.weight_values = to_device<wgt_vt>(weight_val, "weight values");
+    update.new_vertices = added;
+    return update;
+}
+
+//partitions a graph, then applies random batches of changes and checks the maintained cut and part sizes after each
+int run(const char* filename, const config_t& config, int batches, ordinal_t batch_size){
+    //dynamic graphs are only available for the 32-bit types
+    graph_size size = graph_size::standard;
+    if(!probe_graph_size(filename, size)) return -1;
+    if(size != graph_size::standard){
+        std::cerr << "FATAL ERROR: " << filename << " needs 64-bit graph types, which dynamic graphs do not support" << std::endl;
+        return -1;
+    }
+    matrix_t g;
+    wgt_vt vweights;
+    bool uniform_ew = false;
+    if(!load_graph(g, vweights, uniform_ew, filename)) return -1;
+    if(g.numRows() == 0){
+        std::cerr << "FATAL ERROR: " << filename << " has no vertices" << std::endl;
+        return -1;
+    }
+    experiment_data<value_t> experiment;
+    value_t edgecut = 0;
+    part_vt part = partition(edgecut, config, g, vweights, uniform_ew, experiment);
+    dynamic_graph dg;
+    init_dynamic(dg, config, g, vweights, part);
+    std::mt19937 rng(config.seed);
+    int failed = 0;
+    Kokkos::Timer t;
+    for(int b = 0; b < batches; b++){
+        graph_update update = random_batch(dynamic_matrix(dg), batch_size, rng);
+        edgecut = update_dynamic(dg, update);
+        bool ok = verify_dynamic(dg);
+        if(!ok) failed++;
+        std::cout << "batch " << b << ": edgecut " << edgecut << (ok ? "" : " (inconsistent)") << std::endl;
+    }
+    std::cout << "batches: " << batches << "; inconsistent: " << failed << "; time: " << t.seconds() << " seconds" << std::endl;
+    return failed == 0 ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+
+    if (argc < 3) {
+        std::cerr << "Insufficient number of args provided" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <graph_file> <config_file> <optional batch_count> <optional batch_size>" << std::endl;
+        return -1;
+    }
+    config_t config;
+    if(!load_config(config, argv[2])) return -1;
+    int batches = 10;
+    if(argc >= 4){
+        batches = std::max(1, atoi(argv[3]));
+    }
+    ordinal_t batch_size = 1000;
+    if(argc >= 5){
+        batch_size = std::max(1, atoi(argv[4]));
+    }
+    config.verbose = false;
+    //batches are random but reproducible
+    config.seed = 1;
+    if(getenv("JET_SEED") != nullptr) config.seed = strtoull(getenv("JET_SEED"), nullptr, 10);
+
+    Kokkos::initialize();
+    //must scope kokkos-related data
+    //so that it falls out of scope b4 finalize
+    int ret = run(argv[1], config, batches, batch_size);
+    Kokkos::finalize();
+
+    return ret;
+}
@@ -44,89 +44,31 @@
 
 using namespace jet_partitioner;
 
-//loads a sequence of coarse graphs and mappings between each graph from binary file
+//refines a coarse hierarchy imported from fname
 //used to control for coarsening when experimenting with refinement
-std::list<typename jet_partitioner::contracter<matrix_t>::coarse_level_triple> load_coarse(){
-    using coarse_level_triple = typename jet_partitioner::contracter<matrix_t>::coarse_level_triple;
-    std::list<coarse_level_triple> levels;
-    std::list<coarse_level_triple> error_levels;
-    FILE* cgfp = fopen("coarse_graphs.out", "r");
-    int size = 0;
-    if(fread(&size, sizeof(int), 1, cgfp) != 1) return error_levels;
-    std::cout << "Importing " << size << " coarsened graphs" << std::endl;
-    ordinal_t prev_n = 0;
-    for(int i = 0; i < size; i++){
-        coarse_level_triple level;
-        level.level = i + 1;
-        ordinal_t N = 0;
-        if(fread(&N, sizeof(ordinal_t), 1, cgfp) != 1)  return error_levels;
-        edge_offset_t M = 0;
-        if(fread(&M, sizeof(edge_offset_t), 1, cgfp) != 1) return error_levels;
-        edge_vt rows("rows", N + 1);
-        auto rows_m = Kokkos::create_mirror_view(rows);
-        if(fread(rows_m.data(), sizeof(edge_offset_t), N + 1, cgfp) != static_cast<size_t>(N + 1)) return error_levels;
-        Kokkos::deep_copy(rows, rows_m);
-        vtx_vt entries("entries", M);
-        auto entries_m = Kokkos::create_mirror_view(entries);
-        if(fread(entries_m.data(), sizeof(ordinal_t), M, cgfp) != static_cast<size_t>(M)) return error_levels;
-        Kokkos::deep_copy(entries, entries_m);
-        wgt_vt values("values", M);
-        auto values_m = Kokkos::create_mirror_view(values);
-        if(fread(values_m.data(), sizeof(value_t), M, cgfp) != static_cast<size_t>(M))  return error_levels;
-        Kokkos::deep_copy(values, values_m);
-        graph_t graph(entries, rows);
-        matrix_t g("g", N, values, graph);
-        level.mtx = g;
-        wgt_vt vtx_wgts("vtx wgts", N);
-        auto vtx_wgts_m = Kokkos::create_mirror_view(vtx_wgts);
-        if(fread(vtx_wgts_m.data(), sizeof(value_t), N, cgfp) != static_cast<size_t>(N)) return error_levels;
-        Kokkos::deep_copy(vtx_wgts, vtx_wgts_m);
-        level.vtx_w = vtx_wgts;
-        if(level.level > 1){
-            vtx_vt i_entries("entries", prev_n);
-            auto i_entries_m = Kokkos::create_mirror_view(i_entries);
-            if(fread(i_entries_m.data(), sizeof(ordinal_t), prev_n, cgfp) != static_cast<size_t>(prev_n)) return error_levels;
-            Kokkos::deep_copy(i_entries, i_entries_m);
-            typename jet_partitioner::contracter<matrix_t>::coarse_map i_g;
-            i_g.coarse_vtx = N;
-            i_g.map = i_entries;
-            level.interp_mtx = i_g;
-        }
-        prev_n = N;
-        levels.push_back(level);
-    }
-    fclose(cgfp);
-    return levels;
-}
-
-//reads part from binary file
-part_vt load_coarse_part(ordinal_t n){
-    FILE* cgfp = fopen("coarse_part.out", "r");
-    part_vt part("part", n);
-    auto part_m = Kokkos::create_mirror_view(part);
-    if(fread(part_m.data(), sizeof(part_t), n, cgfp) != static_cast<size_t>(n)) return part;
-    Kokkos::deep_copy(part, part_m);
-    fclose(cgfp);
-    return part;
-}
-
-part_vt partition(value_t& edge_cut,
+template<class crsMat>
+bool partition(part_vt& part, typename crsMat::value_type& edge_cut,
+                    const char* fname,
                     const config_t& config,
-                    experiment_data<value_t>& experiment) {
-
-    using coarsener_t = contracter<matrix_t>;
-    using uncoarsener_t = uncoarsener<matrix_t, part_t>;
-    using coarse_level_triple = typename coarsener_t::coarse_level_triple;
-
-    std::list<coarse_level_triple> cg_list = load_coarse();
+                    experiment_data<typename crsMat::value_type>& experiment) {
+
+    using dump_t = binary_dump<crsMat, part_t>;
+    using uncoarsener_t = uncoarsener<crsMat, part_t>;
+    using coarse_level_triple = typename contracter<crsMat>::coarse_level_triple;
+
+    //the coarse graphs may alias this mapping, so it must outlive them
+    mapped_file f;
+    std::list<coarse_level_triple> cg_list;
+    part_vt coarsest_p;
+    if(!dump_t::load_coarse(fname, f, cg_list, coarsest_p)) return false;
+    std::cout << "Imported " << cg_list.size() << " coarsened graphs" << std::endl;
     Kokkos::fence();
     Kokkos::Timer t;
     double start_time = t.seconds();
     double fin_coarsening_time = t.seconds();
-    part_vt coarsest_p = load_coarse_part(cg_list.back().mtx.numRows());
     Kokkos::fence();
     experiment.addMeasurement(Measurement::InitPartition, t.seconds() - fin_coarsening_time);
-    part_vt part = uncoarsener_t::uncoarsen(cg_list, coarsest_p, config,
+    part = uncoarsener_t::uncoarsen(cg_list, coarsest_p, config,
         edge_cut, experiment);
 
     Kokkos::fence();
@@ -141,7 +83,40 @@ part_vt partition(value_t& edge_cut,
     experiment.refinementReport();
     experiment.verboseReport();
 
-    return part;
+    return true;
+}
+
+//runs every partitioning attempt with the graph types chosen by main
+template<class crsMat>
+int run_attempts(const char* fname, const config_t& config, const char* part_file, const char* metrics){
+    using scalar_t = typename crsMat::value_type;
+    part_vt best_part;
+
+    scalar_t edgecut_min = std::numeric_limits<scalar_t>::max();
+    for (int i=0; i < config.num_iter; i++) {
+        Kokkos::fence();
+        scalar_t edgecut = 0;
+        experiment_data<scalar_t> experiment;
+        part_vt part;
+        if(!partition<crsMat>(part, edgecut, fname, config, experiment)) return -1;
+
+        if (edgecut < edgecut_min) {
+            edgecut_min = edgecut;
+            best_part = part;
+        }
+        bool first = true, last = true;
+        if (i > 0) {
+            first = false;
+        }
+        if (i + 1 < config.num_iter) {
+            last = false;
+        }
+        if(metrics != nullptr) experiment.log(metrics, first, last);
+    }
+    std::cout << "Imported coarse graphs, min edgecut found is " << edgecut_min << std::endl;
+
+    if(part_file != nullptr && config.num_iter > 0) write_part(best_part, part_file);
+    return 0;
 }
 
 void degree_weighting(const matrix_t& g, wgt_vt vweights){
@@ -168,37 +143,28 @@ int main(int argc, char **argv) {
         metrics = argv[3];
     }
 
+    const char* fname = coarse_hierarchy_file();
     Kokkos::initialize();
     //must scope kokkos-related data
     //so that it falls out of scope b4 finalize
+    int ret = 0;
     {
-        part_vt best_part;
-
-        value_t edgecut_min = std::numeric_limits<value_t>::max();
-        for (int i=0; i < config.num_iter; i++) {
-            Kokkos::fence();
-            value_t edgecut = 0;
-            experiment_data<value_t> experiment;
-            part_vt part = partition(edgecut, config, experiment);
-
-            if (edgecut < edgecut_min) {
-                edgecut_min = edgecut;
-                best_part = part;
-            }
-            bool first = true, last = true;
-            if (i > 0) {
-                first = false;
-            }
-            if (i + 1 < config.num_iter) {
-                last = false;
-            }
-            if(metrics != nullptr) experiment.log(metrics, first, last);
+        //pick the graph types that match the widths stored in the hierarchy
+        mapped_file f;
+        hierarchy_header h;
+        std::vector<hierarchy_level> table;
+        if(!f.open(fname) || !binary_dump<matrix_t, part_t>::read_header(f, h, table)){
+            std::cerr << "FATAL ERROR: " << fname << " is not a valid coarse hierarchy file" << std::endl;
+            ret = -1;
+        } else if(h.ordinal_width == sizeof(big_ordinal_t)){
+            ret = run_attempts<biggest_matrix_t>(fname, config, part_file, metrics);
+        } else if(h.offset_width == sizeof(big_offset_t) || h.value_width == sizeof(big_val_t)){
+            ret = run_attempts<big_matrix_t>(fname, config, part_file, metrics);
+        } else {
+            ret = run_attempts<matrix_t>(fname, config, part_file, metrics);
         }
-        std::cout << "Imported coarse graphs, min edgecut found is " << edgecut_min << std::endl;
-
-        if(part_file != nullptr && config.num_iter > 0) write_part(best_part, part_file);
     }
     Kokkos::finalize();
 
-    return 0;
+    return ret;
 }
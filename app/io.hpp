@@ -39,14 +39,122 @@
 #pragma once
 #include "jet_defs.h"
 #include "jet_config.h"
+#include "mapped_file.hpp"
+#include "binary_graph.hpp"
+#include "edge_list.hpp"
 #include <sstream>
 #include <string>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cmath>
+#include <list>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <limits>
+#include <iterator>
+#include <type_traits>
+#ifdef JET_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef JET_HAVE_ZSTD
+#include <zstd.h>
+#endif
 
 namespace jet_partitioner {
 
+//parses an integer or floating point value, the entire string must be consumed
+template<typename t>
+bool parse_value(const std::string& value, t& out){
+    if(value.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    if constexpr(std::is_floating_point<t>::value){
+        out = static_cast<t>(strtod(value.c_str(), &end));
+    } else if constexpr(std::is_signed<t>::value){
+        long long x = strtoll(value.c_str(), &end, 10);
+        if(x < std::numeric_limits<t>::min() || x > std::numeric_limits<t>::max()) return false;
+        out = static_cast<t>(x);
+    } else {
+        if(value[0] == '-') return false;
+        unsigned long long x = strtoull(value.c_str(), &end, 10);
+        if(x > std::numeric_limits<t>::max()) return false;
+        out = static_cast<t>(x);
+    }
+    return errno == 0 && *end == '\0';
+}
+
+//sets a single config field by name
+//error is set and false returned for unknown keys and malformed values
+bool set_config_field(jet_partitioner::config_t& c, const std::string& key, const std::string& value, std::string& error){
+    bool ok = false;
+    bool known = true;
+    if(key == "coarsening_alg") ok = parse_value(value, c.coarsening_alg);
+    else if(key == "num_parts") ok = parse_value(value, c.num_parts) && c.num_parts > 0;
+    else if(key == "num_iter") ok = parse_value(value, c.num_iter) && c.num_iter > 0;
+    else if(key == "max_imb_ratio") ok = parse_value(value, c.max_imb_ratio) && c.max_imb_ratio >= 1.0;
+    else if(key == "refine_tolerance") ok = parse_value(value, c.refine_tolerance);
+    else if(key == "seed") ok = parse_value(value, c.seed);
+    else if(key == "ultra_settings"){
+        int ultra = 0;
+        ok = parse_value(value, ultra);
+        c.ultra_settings = (ultra != 0);
+    }
+    else if(key == "coarse_vertices_per_part") ok = parse_value(value, c.coarse_vertices_per_part) && c.coarse_vertices_per_part > 0;
+    else if(key == "coarse_cutoff") ok = parse_value(value, c.coarse_cutoff) && c.coarse_cutoff >= 0;
+    else if(key == "max_levels") ok = parse_value(value, c.max_levels) && c.max_levels > 0;
+    else if(key == "lp_temp_uniform") ok = parse_value(value, c.lp_temp_uniform) && c.lp_temp_uniform > 0 && c.lp_temp_uniform <= 1;
+    else if(key == "lp_temp_weighted") ok = parse_value(value, c.lp_temp_weighted) && c.lp_temp_weighted > 0 && c.lp_temp_weighted <= 1;
+    else if(key == "ultra_temp_start") ok = parse_value(value, c.ultra_temp_start) && c.ultra_temp_start > 0 && c.ultra_temp_start <= 1;
+    else if(key == "ultra_temp_step") ok = parse_value(value, c.ultra_temp_step) && c.ultra_temp_step > 0;
+    else if(key == "refine_patience") ok = parse_value(value, c.refine_patience) && c.refine_patience > 0;
+    else if(key == "max_buckets") ok = parse_value(value, c.max_buckets) && c.max_buckets >= 4 && c.max_buckets <= 64;
+    else if(key == "max_sections") ok = parse_value(value, c.max_sections) && c.max_sections > 0 && c.max_sections <= 4096;
+    else if(key == "update_large_ratio") ok = parse_value(value, c.update_large_ratio) && c.update_large_ratio >= 0;
+    else known = false;
+    if(!known){
+        error = "unknown config key " + key;
+    } else if(!ok){
+        error = "invalid value " + value + " for config key " + key;
+    }
+    return ok;
+}
+
+//reads a config file of key=value lines, blank lines and everything after a # are ignored
+bool load_keyed_config(jet_partitioner::config_t& c, std::ifstream& f, const char* config_f){
+    std::string line;
+    int line_num = 0;
+    while(std::getline(f, line)){
+        line_num++;
+        size_t comment = line.find('#');
+        if(comment != std::string::npos) line.erase(comment);
+        size_t first = line.find_first_not_of(" \t\r");
+        if(first == std::string::npos) continue;
+        size_t last = line.find_last_not_of(" \t\r");
+        line = line.substr(first, last - first + 1);
+        size_t eq = line.find('=');
+        std::string error = "expected key=value";
+        if(eq != std::string::npos){
+            std::string key = line.substr(0, eq);
+            std::string value = line.substr(eq + 1);
+            key.erase(key.find_last_not_of(" \t") + 1);
+            value.erase(0, value.find_first_not_of(" \t"));
+            if(set_config_field(c, key, value, error)) continue;
+        }
+        std::cerr << "FATAL ERROR: " << config_f << ":" << line_num << ": " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
 bool load_config(jet_partitioner::config_t& c, const char* config_f) {
 
     std::ifstream f(config_f);
@@ -54,6 +162,13 @@ bool load_config(jet_partitioner::config_t& c, const char* config_f) {
         std::cerr << "FATAL ERROR: Could not open config file " << config_f << std::endl;
         return false;
     }
+    //files with an = anywhere are keyed, otherwise the legacy positional format is used
+    std::string contents((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.clear();
+    f.seekg(0);
+    if(contents.find('=') != std::string::npos){
+        return load_keyed_config(c, f, config_f);
+    }
     std::string lines[5];
     int reads = 0;
     // you might think that reading in four lines from a simple config file could be done like:
@@ -96,34 +211,563 @@ void next_line(const char*& str){
     str++;
 }
 
-bool load_metis_graph(matrix_t& g, bool& uniform_ew, const char *fname) {
-    Kokkos::Timer t;
-    std::ifstream infp(fname, std::ios::binary);
-    if (!infp.is_open()) {
-        std::cerr << "FATAL ERROR: Could not open metis graph file " << fname << std::endl;
-        return false;
+using host_policy = Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>;
+
+//running line and token counts at some position of a metis file body
+struct parse_counts {
+    size_t lines = 0;
+    size_t tokens = 0;
+};
+
+//splits [begin, end) into chunks that each start at the beginning of a line
+//end must point one past a newline
+std::vector<const char*> split_lines(const char* begin, const char* end, size_t min_chunk){
+    size_t len = end - begin;
+    size_t max_chunks = 8*Kokkos::DefaultHostExecutionSpace().concurrency();
+    size_t chunks = std::max<size_t>(1, std::min(max_chunks, len / min_chunk));
+    std::vector<const char*> bounds(chunks + 1, end);
+    bounds[0] = begin;
+    for(size_t i = 1; i < chunks; i++){
+        const char* f = std::max(begin + (len / chunks) * i, bounds[i - 1]);
+        const char* nl = static_cast<const char*>(memchr(f, '\n', end - f));
+        bounds[i] = (nl == nullptr) ? end : nl + 1;
     }
-    infp.seekg(0, std::ios::end);
-    size_t sz = infp.tellg();
-    std::cout << "Reading " << sz << " bytes from " << fname << std::endl;
-    infp.seekg(0, std::ios::beg);
+    return bounds;
+}
+
+//counts the rows and numeric tokens in a chunk
+//must follow the exact same rules as parse_chunk
+parse_counts count_chunk(const char* f, const char* fmax){
+    parse_counts c;
+    while(f < fmax){
+        if(isdigit(*f)){
+            c.tokens++;
+            while(isdigit(*f)) f++;
+        } else if(*f == '%'){
+            //ignore commented lines
+            next_line(f);
+        } else {
+            if(*f == '\n') c.lines++;
+            f++;
+        }
+    }
+    return c;
+}
+
+//writes the rows and nonzeros in a chunk
+//offset contains the lines and tokens that precede this chunk
+template<class row_mt, class entries_mt, class values_mt>
+void parse_chunk(const char* f, const char* fmax, parse_counts offset, size_t n, size_t nnz, bool has_ew,
+    row_mt row_map, entries_mt entries, values_mt values){
+    size_t lines = offset.lines;
+    size_t tokens = offset.tokens;
+    while(f < fmax){
+        if(isdigit(*f)){
+            //fast_atoi also increments past numeric chars
+            int64_t edge_info = fast_atoi<int64_t>(f);
+            //edge weights alternate with edge endpoints when present
+            size_t e = has_ew ? tokens / 2 : tokens;
+            if(e < nnz){
+                if(has_ew && (tokens % 2) == 1){
+                    values(e) = edge_info;
+                } else {
+                    //subtract 1 to convert to 0-indexed
+                    entries(e) = edge_info - 1;
+                }
+            }
+            tokens++;
+        } else if(*f == '%'){
+            //ignore commented lines
+            next_line(f);
+        } else {
+            if(*f == '\n'){
+                lines++;
+                //ignore extra trailing newlines
+                if(lines <= n) row_map(lines) = has_ew ? tokens / 2 : tokens;
+            }
+            f++;
+        }
+    }
+}
+
+//parses the body of a metis file in parallel
+//first counts rows and tokens per chunk, then prefix sums the counts
+//so that each chunk knows where to write its rows and nonzeros
+//returns the counts at the end of the parsed region
+template<class row_mt, class entries_mt, class values_mt>
+parse_counts parse_metis_body(const char* begin, const char* end, parse_counts offset, size_t n, size_t nnz, bool has_ew,
+    row_mt row_map, entries_mt entries, values_mt values){
+    std::vector<const char*> bounds = split_lines(begin, end, 1 << 16);
+    size_t chunks = bounds.size() - 1;
+    std::vector<parse_counts> counts(chunks + 1);
+    Kokkos::parallel_for("count metis chunks", host_policy(0, chunks), [&](const size_t i){
+        counts[i + 1] = count_chunk(bounds[i], bounds[i + 1]);
+    });
+    Kokkos::DefaultHostExecutionSpace().fence();
+    counts[0] = offset;
+    for(size_t i = 1; i <= chunks; i++){
+        counts[i].lines += counts[i - 1].lines;
+        counts[i].tokens += counts[i - 1].tokens;
+    }
+    Kokkos::parallel_for("parse metis chunks", host_policy(0, chunks), [&](const size_t i){
+        parse_chunk(bounds[i], bounds[i + 1], counts[i], n, nnz, has_ew, row_map, entries, values);
+    });
+    Kokkos::DefaultHostExecutionSpace().fence();
+    return counts[chunks];
+}
+
+//returns a pointer one past the end of the line containing f
+const char* line_end(const char* f, const char* fmax){
+    const char* nl = static_cast<const char*>(memchr(f, '\n', fmax - f));
+    return (nl == nullptr) ? fmax : nl + 1;
+}
+
+//returns a pointer one past the last newline in [begin, end)
+//returns begin if there is no newline
+const char* last_line_end(const char* begin, const char* end){
+    const char* f = end;
+    while(f > begin && *(f - 1) != '\n') f--;
+    return f;
+}
+
+//supplies the text of a metis file as a sequence of windows
+//every window ends with a newline so that no line is split between windows
+class line_source {
+public:
+    //total bytes of input consumed so far
+    size_t bytes = 0;
+    bool failed = false;
+
+    virtual ~line_source() {}
+    //sets [begin, end) to the next window, returns false once the input is exhausted
+    //the previous window is invalidated
+    virtual bool next(const char*& begin, const char*& end) = 0;
+};
+
+//windows over a memory mapped file
+//pages behind the current window are released from memory
+class mapped_source : public line_source {
+public:
+    mapped_file f;
+    const char* cursor = nullptr;
+    const char* body_end = nullptr;
+    //everything before this page-aligned position has already been released
+    const char* released = nullptr;
+    size_t window = 0;
+    //the final line may not end with a newline
+    //it is copied into a separate buffer so the parser never reads past the mapping
+    std::string tail;
+    bool tail_done = false;
+
+bool open(const char* fname, size_t _window){
+    if(!f.open(fname)) return false;
+    f.advise_sequential();
+    window = _window;
+    cursor = f.data;
+    released = f.data;
+    body_end = last_line_end(f.data, f.data + f.size);
+    return true;
+}
+
+bool next(const char*& begin, const char*& end) override {
+    //only the pages passed since the last window are released, so the work per window stays constant
+    f.release(released, cursor);
+    size_t page = sysconf(_SC_PAGESIZE);
+    released = f.data + (cursor - f.data) / page * page;
+    if(cursor < body_end){
+        const char* window_end = body_end;
+        if(static_cast<size_t>(body_end - cursor) > window){
+            window_end = last_line_end(cursor, cursor + window);
+            //a single line is longer than the window
+            if(window_end == cursor) window_end = line_end(cursor + window, body_end);
+        }
+        begin = cursor;
+        end = window_end;
+        bytes += end - begin;
+        cursor = window_end;
+        return true;
+    }
+    if(!tail_done && body_end < f.data + f.size){
+        tail_done = true;
+        tail.assign(body_end, f.data + f.size);
+        bytes += tail.size();
+        tail.push_back('\n');
+        begin = tail.data();
+        end = begin + tail.size();
+        return true;
+    }
+    return false;
+}
+};
+
+//reads a file through a fixed size buffer so that memory used for text is strictly bounded
+//also used for inputs that can't be mapped, such as pipes
+//a partial line at the end of the buffer is carried over to the front of the next window
+class buffered_source : public line_source {
+public:
+    int fd = -1;
+    std::vector<char> buf;
+    //buf[carry_begin, filled) holds input that has not been handed out yet
+    size_t carry_begin = 0;
+    size_t filled = 0;
+    bool eof = false;
+
+    ~buffered_source(){
+        if(fd >= 0) ::close(fd);
+    }
+
+bool open(const char* fname, size_t buffer_bytes){
+    fd = ::open(fname, O_RDONLY);
     //1 for extra newline if needed
-    char* s = new char[sz + 1];
-    infp.read(s, sz);
-    infp.close();
-    std::cout << "Read graph from " << fname << " in " << std::setprecision(3) << t.seconds() << "s" << std::endl;
-    //append an endline to end of file in case one doesn't exist
-    //needed to prevent parser from overshooting end of buffer
-    if(s[sz - 1] != '\n'){
-        s[sz] = '\n';
-        sz++;
-    }
-    const char* f = s;
-    const char* fmax = s + sz;
-    size_t header[4] = {0, 0, 0, 0};
-    //ignore commented lines
-    while(*f == '%') next_line(f);
-    while(!isdigit(*f)) f++;
+    buf.resize(buffer_bytes + 1);
+    return fd >= 0;
+}
+
+bool next(const char*& begin, const char*& end) override {
+    //move the partial line left over from the previous window to the front
+    size_t carry = filled - carry_begin;
+    memmove(buf.data(), buf.data() + carry_begin, carry);
+    filled = carry;
+    carry_begin = 0;
+    while(true){
+        size_t capacity = buf.size() - 1;
+        while(!eof && filled < capacity){
+            ssize_t r = read(fd, buf.data() + filled, capacity - filled);
+            if(r < 0 && errno == EINTR) continue;
+            if(r <= 0){
+                failed = (r < 0);
+                eof = true;
+                break;
+            }
+            filled += r;
+            bytes += r;
+        }
+        if(filled == 0) return false;
+        char* data = buf.data();
+        if(eof){
+            //append an endline to end of file in case one doesn't exist
+            if(data[filled - 1] != '\n') data[filled++] = '\n';
+            begin = data;
+            end = data + filled;
+            carry_begin = filled;
+            return true;
+        }
+        const char* window_end = last_line_end(data, data + filled);
+        if(window_end > data){
+            begin = data;
+            end = window_end;
+            carry_begin = window_end - data;
+            return true;
+        }
+        //a single line is longer than the buffer
+        buf.resize(2*capacity + 1);
+    }
+}
+};
+
+//decompresses a file into caller provided buffers
+class decompressor {
+public:
+    bool failed = false;
+
+    virtual ~decompressor() {}
+    //returns the number of bytes written to dst, 0 at the end of input
+    virtual size_t read(char* dst, size_t len) = 0;
+};
+
+#ifdef JET_HAVE_ZLIB
+class gzip_decompressor : public decompressor {
+public:
+    gzFile gz = nullptr;
+
+    ~gzip_decompressor(){
+        if(gz != nullptr) gzclose(gz);
+    }
+
+bool open(const char* fname){
+    gz = gzopen(fname, "rb");
+    if(gz == nullptr) return false;
+    gzbuffer(gz, 1 << 20);
+    return true;
+}
+
+size_t read(char* dst, size_t len) override {
+    //gzread takes an unsigned length
+    unsigned chunk = static_cast<unsigned>(std::min<size_t>(len, 1u << 30));
+    int r = gzread(gz, dst, chunk);
+    if(r < 0){
+        failed = true;
+        return 0;
+    }
+    return r;
+}
+};
+#endif
+
+#ifdef JET_HAVE_ZSTD
+class zstd_decompressor : public decompressor {
+public:
+    FILE* fp = nullptr;
+    ZSTD_DStream* ds = nullptr;
+    std::vector<char> in_buf;
+    ZSTD_inBuffer in = {nullptr, 0, 0};
+
+    ~zstd_decompressor(){
+        if(ds != nullptr) ZSTD_freeDStream(ds);
+        if(fp != nullptr) fclose(fp);
+    }
+
+bool open(const char* fname){
+    fp = fopen(fname, "rb");
+    if(fp == nullptr) return false;
+    ds = ZSTD_createDStream();
+    if(ds == nullptr) return false;
+    ZSTD_initDStream(ds);
+    in_buf.resize(ZSTD_DStreamInSize());
+    in.src = in_buf.data();
+    return true;
+}
+
+size_t read(char* dst, size_t len) override {
+    ZSTD_outBuffer out = {dst, len, 0};
+    while(out.pos < out.size){
+        bool input_done = false;
+        if(in.pos == in.size){
+            size_t r = fread(in_buf.data(), 1, in_buf.size(), fp);
+            if(r == 0){
+                failed = ferror(fp);
+                input_done = true;
+            } else {
+                in.size = r;
+                in.pos = 0;
+            }
+        }
+        size_t before = out.pos;
+        size_t ret = ZSTD_decompressStream(ds, &out, &in);
+        if(ZSTD_isError(ret)){
+            failed = true;
+            break;
+        }
+        //the decoder may still flush buffered output after the input is exhausted
+        if(input_done && out.pos == before) break;
+    }
+    return out.pos;
+}
+};
+#endif
+
+enum class compression { none, gzip, zstd };
+
+//identifies compressed files by their magic bytes
+//only regular files are checked so that no input is consumed from pipes
+compression detect_compression(const char* fname){
+    struct stat st;
+    if(stat(fname, &st) != 0 || !S_ISREG(st.st_mode)) return compression::none;
+    unsigned char magic[4] = {0, 0, 0, 0};
+    FILE* fp = fopen(fname, "rb");
+    if(fp == nullptr) return compression::none;
+    size_t r = fread(magic, 1, 4, fp);
+    fclose(fp);
+    if(r >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) return compression::gzip;
+    if(r == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) return compression::zstd;
+    return compression::none;
+}
+
+std::unique_ptr<decompressor> open_decompressor(const char* fname, compression c){
+    if(c == compression::gzip){
+#ifdef JET_HAVE_ZLIB
+        auto dec = std::make_unique<gzip_decompressor>();
+        if(dec->open(fname)) return dec;
+#else
+        std::cerr << "FATAL ERROR: " << fname << " is gzip compressed but jet was built without zlib" << std::endl;
+#endif
+    } else if(c == compression::zstd){
+#ifdef JET_HAVE_ZSTD
+        auto dec = std::make_unique<zstd_decompressor>();
+        if(dec->open(fname)) return dec;
+#else
+        std::cerr << "FATAL ERROR: " << fname << " is zstd compressed but jet was built without zstd" << std::endl;
+#endif
+    }
+    return nullptr;
+}
+
+//decompresses on a separate thread into two alternating buffers
+//the parser works on one buffer while the other is being filled
+//the producer moves the partial line at the end of each buffer to the front of the next
+class decompress_source : public line_source {
+public:
+    struct slot {
+        std::vector<char> buf;
+        size_t len = 0;
+        bool ready = false;
+    };
+    std::unique_ptr<decompressor> dec;
+    slot slots[2];
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::thread producer;
+    //set by the producer once the final buffer is ready
+    bool done = false;
+    //set by the consumer to stop the producer early
+    bool stop = false;
+    int consume_idx = 0;
+    bool holding = false;
+
+    ~decompress_source(){
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stop = true;
+        }
+        cv.notify_all();
+        if(producer.joinable()) producer.join();
+    }
+
+void start(std::unique_ptr<decompressor> _dec, size_t buffer_bytes){
+    dec = std::move(_dec);
+    //1 for extra newline if needed
+    for(slot& s : slots) s.buf.resize(buffer_bytes + 1);
+    producer = std::thread([this](){ produce(); });
+}
+
+void produce(){
+    std::vector<char> carry;
+    int idx = 0;
+    bool eof = false;
+    while(!eof){
+        slot& s = slots[idx];
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&](){ return !s.ready || stop; });
+            if(stop) return;
+        }
+        //this thread owns s until it is marked ready
+        //the other buffer may have grown to fit a long line
+        if(s.buf.size() < carry.size() + 1) s.buf.resize(2*carry.size() + 1);
+        if(!carry.empty()) memcpy(s.buf.data(), carry.data(), carry.size());
+        size_t filled = carry.size();
+        size_t window_len = 0;
+        while(window_len == 0){
+            size_t capacity = s.buf.size() - 1;
+            while(filled < capacity){
+                size_t r = dec->read(s.buf.data() + filled, capacity - filled);
+                if(r == 0){
+                    eof = true;
+                    break;
+                }
+                filled += r;
+            }
+            if(eof){
+                //append an endline to end of file in case one doesn't exist
+                if(filled > 0 && s.buf[filled - 1] != '\n') s.buf[filled++] = '\n';
+                window_len = filled;
+                break;
+            }
+            window_len = last_line_end(s.buf.data(), s.buf.data() + filled) - s.buf.data();
+            //a single line is longer than the buffer
+            if(window_len == 0) s.buf.resize(2*capacity + 1);
+        }
+        carry.assign(s.buf.data() + window_len, s.buf.data() + filled);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            s.len = window_len;
+            s.ready = true;
+            if(eof){
+                failed = dec->failed;
+                done = true;
+            }
+        }
+        cv.notify_all();
+        idx = 1 - idx;
+    }
+}
+
+bool next(const char*& begin, const char*& end) override {
+    std::unique_lock<std::mutex> lock(mtx);
+    if(holding){
+        //hand the previous buffer back to the producer
+        slots[consume_idx].ready = false;
+        consume_idx = 1 - consume_idx;
+        holding = false;
+        cv.notify_all();
+    }
+    //buffers are filled in order, so if this one isn't ready after the producer is done
+    //then every buffer has been consumed
+    cv.wait(lock, [&](){ return slots[consume_idx].ready || done; });
+    slot& s = slots[consume_idx];
+    if(!s.ready) return false;
+    holding = true;
+    if(s.len == 0) return false;
+    begin = s.buf.data();
+    end = begin + s.len;
+    bytes += s.len;
+    return true;
+}
+};
+
+//memory mapped text is parsed in windows of this many bytes
+constexpr size_t parse_window = static_cast<size_t>(1) << 26;
+//buffer size used when an input can't be mapped and no limit is given
+constexpr size_t default_stream_buffer = static_cast<size_t>(256) << 20;
+
+//maximum bytes of file text held in memory at once while loading a metis file
+//for compressed files this is the total size of both decompression buffers
+//set through the JET_IO_LIMIT_MB environment variable
+//0 means the file is memory mapped instead of streamed through a buffer
+size_t io_limit(){
+    const char* env = getenv("JET_IO_LIMIT_MB");
+    if(env == nullptr) return 0;
+    return static_cast<size_t>(strtoull(env, nullptr, 10)) << 20;
+}
+
+//location of the coarse hierarchy written by jet_export and read by jet_import
+//set through the JET_COARSE_FILE environment variable
+const char* coarse_hierarchy_file(){
+    const char* env = getenv("JET_COARSE_FILE");
+    return (env == nullptr) ? "coarse_graphs.out" : env;
+}
+
+std::unique_ptr<line_source> open_line_source(const char* fname, size_t limit){
+    compression c = detect_compression(fname);
+    if(c != compression::none){
+        std::unique_ptr<decompressor> dec = open_decompressor(fname, c);
+        if(dec == nullptr) return nullptr;
+        auto decompressed = std::make_unique<decompress_source>();
+        //the limit is split between the two buffers
+        decompressed->start(std::move(dec), limit == 0 ? parse_window : std::max<size_t>(limit / 2, 1));
+        return decompressed;
+    }
+    if(limit == 0){
+        auto mapped = std::make_unique<mapped_source>();
+        if(mapped->open(fname, parse_window)) return mapped;
+        //fall back to streaming for inputs that can't be mapped
+        limit = default_stream_buffer;
+    }
+    auto buffered = std::make_unique<buffered_source>();
+    if(buffered->open(fname, limit)) return buffered;
+    return nullptr;
+}
+
+//skips comments and reads the header line of a metis file from src
+//on success [f, end) is the rest of the current window, starting after the header line
+bool read_metis_header(line_source& src, const char*& f, const char*& end, size_t header[4]){
+    const char* begin = nullptr;
+    f = nullptr;
+    //ignore commented lines and leading whitespace
+    while(f == nullptr && src.next(begin, end)){
+        f = begin;
+        while(f < end && (*f == '%' || isspace(*f))){
+            if(*f == '%'){
+                f = line_end(f, end);
+            } else {
+                f++;
+            }
+        }
+        if(f == end) f = nullptr;
+    }
+    if(f == nullptr) return false;
+    //windows always end with a newline, so the header line does too
+    while(!isdigit(*f) && *f != '\n') f++;
     //read header data
     for(int i = 0; i < 4; i++){
         header[i] = fast_atoi<size_t>(f);
@@ -136,6 +780,38 @@ bool load_metis_graph(matrix_t& g, bool& uniform_ew, const char *fname) {
             f++;
         }
     }
+    return true;
+}
+
+template<class crsMat>
+bool load_metis_graph(crsMat& g, bool& uniform_ew, const char *fname, size_t limit = io_limit()) {
+    using ordinal_t = typename crsMat::ordinal_type;
+    using edge_offset_t = typename crsMat::size_type;
+    using Device = typename crsMat::device_type;
+    using vtx_vt = Kokkos::View<ordinal_t*, Device>;
+    using edge_vt = Kokkos::View<edge_offset_t*, Device>;
+    using wgt_vt = Kokkos::View<typename crsMat::value_type*, Device>;
+    using graph_t = typename crsMat::staticcrsgraph_type;
+    Kokkos::Timer t;
+    std::unique_ptr<line_source> src = open_line_source(fname, limit);
+    if (src == nullptr) {
+        std::cerr << "FATAL ERROR: Could not open metis graph file " << fname << std::endl;
+        return false;
+    }
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    const char* f = nullptr;
+    size_t header[4] = {0, 0, 0, 0};
+    if(!read_metis_header(*src, f, end, header)){
+        std::cerr << "FATAL ERROR: Metis graph file " << fname << " does not contain a header" << std::endl;
+        return false;
+    }
+    if(header[0] > static_cast<size_t>(std::numeric_limits<ordinal_t>::max())
+        || 2*header[1] > static_cast<size_t>(std::numeric_limits<edge_offset_t>::max())){
+        std::cerr << "FATAL ERROR: Metis graph with " << header[0] << " vertices and " << header[1]
+            << " edges is too large for the requested graph types" << std::endl;
+        return false;
+    }
     ordinal_t n = header[0];
     edge_offset_t m = header[1];
     int fmt = header[2];
@@ -152,55 +828,37 @@ bool load_metis_graph(matrix_t& g, bool& uniform_ew, const char *fname) {
         return false;
     }
     vtx_vt entries(Kokkos::ViewAllocateWithoutInitializing("entries"), m*2);
-    vtx_mt entries_m = Kokkos::create_mirror_view(entries);
+    typename vtx_vt::HostMirror entries_m = Kokkos::create_mirror_view(entries);
     edge_vt row_map(Kokkos::ViewAllocateWithoutInitializing("row map"), n + 1);
-    edge_mt row_map_m = Kokkos::create_mirror_view(row_map);
+    typename edge_vt::HostMirror row_map_m = Kokkos::create_mirror_view(row_map);
     wgt_vt values(Kokkos::ViewAllocateWithoutInitializing("values"), 2*m);
-    wgt_mt values_m;
+    typename wgt_vt::HostMirror values_m;
     if(has_ew){
         values_m = Kokkos::create_mirror_view(values);
     }
-    edge_offset_t edges_read = 0;
-    ordinal_t rows_read = 0;
     row_map_m(0) = 0;
-    bool is_value = false;
     //read edge information
-    while(f < fmax){
-        //increment past whitespace
-        while(f < fmax && !isdigit(*f)){
-            //ignore commented lines
-            if(*f == '%'){
-                next_line(f);
-                continue;
-            }
-            if(*f == '\n'){
-                //ignore extra trailing newlines
-                if(rows_read < n) row_map_m(++rows_read) = edges_read;
-            }
-            f++;
-        }
-        if(f >= fmax) break;
-        //fast_atoi also increments past numeric chars
-        ordinal_t edge_info = fast_atoi<ordinal_t>(f);
-        if(!is_value){
-            //subtract 1 to convert to 0-indexed
-            entries_m(edges_read) = edge_info - 1;
-        } else {
-            values_m(edges_read++) = edge_info;
-        }
-        if(has_ew){
-            is_value = !is_value;
-        } else {
-            edges_read++;
-        }
+    parse_counts total = parse_metis_body(f, end, parse_counts(), n, 2*static_cast<size_t>(m), has_ew, row_map_m, entries_m, values_m);
+    while(src->next(begin, end)){
+        total = parse_metis_body(begin, end, total, n, 2*static_cast<size_t>(m), has_ew, row_map_m, entries_m, values_m);
+    }
+    //includes time spent reading the file
+    double parse_time = t.seconds();
+    size_t parse_bytes = src->bytes;
+    if(src->failed){
+        std::cerr << "FATAL ERROR: Error while reading metis graph file " << fname << std::endl;
+        return false;
     }
-    delete[] s;
-    if(rows_read != n || edges_read != 2*m){
+    size_t rows_read = std::min(total.lines, static_cast<size_t>(n));
+    size_t edges_read = has_ew ? total.tokens / 2 : total.tokens;
+    if(rows_read != static_cast<size_t>(n) || edges_read != 2*static_cast<size_t>(m)){
         std::cerr << "FATAL ERROR: Mismatch between expected and actual line/nonzero count in metis file" << std::endl;
         std::cerr << "Read " << rows_read << " lines and " << edges_read << " nonzeros" << std::endl;
         std::cerr << "Lines expected: " << n << "; Nonzeros expected: " << m*2 << std::endl;
         return false;
     }
+    std::cout << "Parsed " << parse_bytes << " bytes in " << std::setprecision(3) << parse_time << "s ("
+        << (static_cast<double>(parse_bytes) / 1e9 / parse_time) << " GB/s)" << std::endl;
     Kokkos::deep_copy(row_map, row_map_m);
     Kokkos::deep_copy(entries, entries_m);
     if(has_ew){
@@ -211,36 +869,711 @@ bool load_metis_graph(matrix_t& g, bool& uniform_ew, const char *fname) {
         uniform_ew = true;
     }
     graph_t g_graph(entries, row_map);
-    g = matrix_t("input graph", n, values, g_graph);
+    g = crsMat("input graph", n, values, g_graph);
     std::cout << "Processed graph at " << fname << " in " << std::setprecision(3) << t.seconds() << "s" << std::endl;
     return true;
 }
 
-void write_part(part_vt part_d, const char *fname){
-    std::ofstream ofp(fname);
-    if(!ofp.is_open()) return;
+//separators between the fields of an edge list or matrix market line
+bool is_field_sep(char c){
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+//true if the line starting at f describes an edge
+//blank lines and lines starting with % or # are skipped
+bool is_edge_line(const char* f){
+    while(is_field_sep(*f)) f++;
+    return *f != '\n' && *f != '%' && *f != '#';
+}
+
+//reads a non-negative integer field and advances f past it
+bool parse_id(const char*& f, int64_t& id){
+    while(is_field_sep(*f)) f++;
+    if(!isdigit(*f)) return false;
+    id = fast_atoi<int64_t>(f);
+    return is_field_sep(*f) || *f == '\n';
+}
+
+//reads an optional edge weight field
+//real values are rounded and weights are made positive so that every edge has weight at least 1
+//returns false if the field is present but isn't a number that fits scalar_t
+template<typename scalar_t>
+bool parse_weight(const char*& f, scalar_t& w){
+    while(is_field_sep(*f)) f++;
+    if(*f == '\n' || *f == '%' || *f == '#') return true;
+    const char* s = f;
+    double x = 0;
+    if(isdigit(*f)){
+        //fast path for integer weights
+        x = static_cast<double>(fast_atoi<int64_t>(f));
+    }
+    if(!isdigit(*s) || !(is_field_sep(*f) || *f == '\n')){
+        char* stop = nullptr;
+        x = strtod(s, &stop);
+        if(stop == s) return false;
+        f = stop;
+    }
+    x = std::max(1.0, std::round(std::fabs(x)));
+    if(x > static_cast<double>(std::numeric_limits<scalar_t>::max())) return false;
+    w = static_cast<scalar_t>(x);
+    return true;
+}
+
+//edges read from an edge list or matrix market file in file order
+template<typename ordinal_t, typename scalar_t>
+struct edge_triples {
+    std::vector<ordinal_t> src, dst;
+    std::vector<scalar_t> wgts;
+    int64_t max_id = -1;
+    size_t bad_lines = 0;
+};
+
+//counts the edge lines in a chunk
+//must follow the exact same rules as parse_edge_chunk
+size_t count_edge_chunk(const char* f, const char* fmax){
+    size_t edges = 0;
+    while(f < fmax){
+        if(is_edge_line(f)) edges++;
+        f = line_end(f, fmax);
+    }
+    return edges;
+}
+
+//writes the edges in a chunk starting at index offset of out
+//ids are shifted down by base and must lie in [0, id_limit)
+//returns the number of malformed lines; their slots are filled with a self loop that is dropped later
+template<class triples_t>
+size_t parse_edge_chunk(const char* f, const char* fmax, size_t offset, int64_t base, int64_t id_limit, bool read_weights,
+    triples_t& out, int64_t& max_id){
+    size_t bad = 0;
+    while(f < fmax){
+        const char* next = line_end(f, fmax);
+        if(is_edge_line(f)){
+            int64_t u = 0, v = 0;
+            typename decltype(out.wgts)::value_type w = 1;
+            bool ok = parse_id(f, u) && parse_id(f, v);
+            if(ok && read_weights) ok = parse_weight(f, w);
+            u -= base;
+            v -= base;
+            if(!ok || u < 0 || v < 0 || u >= id_limit || v >= id_limit){
+                bad++;
+                u = v = 0;
+            }
+            max_id = std::max(max_id, std::max(u, v));
+            out.src[offset] = u;
+            out.dst[offset] = v;
+            out.wgts[offset] = w;
+            offset++;
+        }
+        f = next;
+    }
+    return bad;
+}
+
+//parses the edge lines in [begin, end) in parallel and appends them to out
+//end must point one past a newline
+template<class triples_t>
+void parse_edge_body(const char* begin, const char* end, int64_t base, int64_t id_limit, bool read_weights, triples_t& out){
+    std::vector<const char*> bounds = split_lines(begin, end, 1 << 16);
+    size_t chunks = bounds.size() - 1;
+    std::vector<size_t> offsets(chunks + 1, 0);
+    Kokkos::parallel_for("count edge chunks", host_policy(0, chunks), [&](const size_t i){
+        offsets[i + 1] = count_edge_chunk(bounds[i], bounds[i + 1]);
+    });
+    Kokkos::DefaultHostExecutionSpace().fence();
+    offsets[0] = out.src.size();
+    for(size_t i = 1; i <= chunks; i++){
+        offsets[i] += offsets[i - 1];
+    }
+    out.src.resize(offsets[chunks]);
+    out.dst.resize(offsets[chunks]);
+    out.wgts.resize(offsets[chunks]);
+    std::vector<size_t> bad(chunks, 0);
+    std::vector<int64_t> max_id(chunks, -1);
+    Kokkos::parallel_for("parse edge chunks", host_policy(0, chunks), [&](const size_t i){
+        bad[i] = parse_edge_chunk(bounds[i], bounds[i + 1], offsets[i], base, id_limit, read_weights, out, max_id[i]);
+    });
+    Kokkos::DefaultHostExecutionSpace().fence();
+    for(size_t i = 0; i < chunks; i++){
+        out.bad_lines += bad[i];
+        out.max_id = std::max(out.max_id, max_id[i]);
+    }
+}
+
+//reads the banner line of a matrix market file
+//only coordinate matrices with pattern, integer or real entries are supported
+bool parse_mtx_banner(const char* f, const char* le, bool& has_values){
+    std::string line(f, le);
+    std::transform(line.begin(), line.end(), line.begin(), [](unsigned char c){ return std::tolower(c); });
+    std::istringstream ss(line);
+    std::string banner, object, format, field, symmetry;
+    ss >> banner >> object >> format >> field >> symmetry;
+    if(banner != "%%matrixmarket" || object != "matrix"){
+        std::cerr << "FATAL ERROR: Missing matrix market banner" << std::endl;
+        return false;
+    }
+    if(format != "coordinate"){
+        std::cerr << "FATAL ERROR: Unsupported matrix market format " << format << std::endl;
+        std::cerr << "Only coordinate matrices can be read as graphs" << std::endl;
+        return false;
+    }
+    if(field != "pattern" && field != "integer" && field != "real" && field != "double"){
+        std::cerr << "FATAL ERROR: Unsupported matrix market field " << field << std::endl;
+        return false;
+    }
+    has_values = (field != "pattern");
+    //every symmetry is accepted because the graph is symmetrized anyway
+    return true;
+}
+
+//loads a matrix market file (mtx is true) or a whitespace separated edge list
+//matrix market ids are 1-indexed, edge list ids are 0-indexed
+//edges are symmetrized, self loops dropped and duplicates combined according to rule
+template<class crsMat>
+bool load_edge_list(crsMat& g, bool& uniform_ew, const char* fname, bool mtx, duplicate_rule rule, size_t limit = io_limit()) {
+    using ordinal_t = typename crsMat::ordinal_type;
+    using scalar_t = typename crsMat::value_type;
+    using Device = typename crsMat::device_type;
+    using vtx_vt = Kokkos::View<ordinal_t*, Device>;
+    using wgt_vt = Kokkos::View<scalar_t*, Device>;
+    Kokkos::Timer t;
+    std::unique_ptr<line_source> src = open_line_source(fname, limit);
+    if (src == nullptr) {
+        std::cerr << "FATAL ERROR: Could not open graph file " << fname << std::endl;
+        return false;
+    }
+    //matrix market files begin with a banner line, comments and a size line
+    bool have_banner = !mtx;
+    bool have_size = !mtx;
+    bool has_values = true;
+    int64_t rows = 0, cols = 0, expected = 0;
+    edge_triples<ordinal_t, scalar_t> edges;
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    while(src->next(begin, end)){
+        const char* f = begin;
+        while(!have_size && f < end){
+            const char* next = line_end(f, end);
+            if(!have_banner){
+                if(!parse_mtx_banner(f, next, has_values)) return false;
+                have_banner = true;
+            } else if(is_edge_line(f)){
+                if(!parse_id(f, rows) || !parse_id(f, cols) || !parse_id(f, expected)){
+                    std::cerr << "FATAL ERROR: Invalid matrix market size line" << std::endl;
+                    return false;
+                }
+                if(rows != cols){
+                    std::cerr << "FATAL ERROR: Matrix market file describes a " << rows << "x" << cols << " matrix" << std::endl;
+                    std::cerr << "Only square matrices can be read as graphs" << std::endl;
+                    return false;
+                }
+                if(rows > static_cast<int64_t>(std::numeric_limits<ordinal_t>::max())){
+                    std::cerr << "FATAL ERROR: Matrix market file with " << rows << " rows is too large for the requested graph types" << std::endl;
+                    return false;
+                }
+                have_size = true;
+            }
+            f = next;
+        }
+        int64_t base = mtx ? 1 : 0;
+        int64_t id_limit = mtx ? rows : static_cast<int64_t>(std::numeric_limits<ordinal_t>::max());
+        parse_edge_body(f, end, base, id_limit, has_values, edges);
+    }
+    double parse_time = t.seconds();
+    size_t parse_bytes = src->bytes;
+    if(src->failed){
+        std::cerr << "FATAL ERROR: Error while reading graph file " << fname << std::endl;
+        return false;
+    }
+    if(!have_size){
+        std::cerr << "FATAL ERROR: Matrix market file " << fname << " does not contain a header" << std::endl;
+        return false;
+    }
+    if(edges.bad_lines > 0){
+        std::cerr << "FATAL ERROR: " << edges.bad_lines << " lines in " << fname << " are not valid edges" << std::endl;
+        return false;
+    }
+    size_t m = edges.src.size();
+    if(mtx && m != static_cast<size_t>(expected)){
+        std::cerr << "FATAL ERROR: Mismatch between expected and actual entry count in matrix market file" << std::endl;
+        std::cerr << "Read " << m << " entries; Entries expected: " << expected << std::endl;
+        return false;
+    }
+    ordinal_t n = mtx ? static_cast<ordinal_t>(rows) : static_cast<ordinal_t>(edges.max_id + 1);
+    if(n == 0){
+        std::cerr << "FATAL ERROR: Graph file " << fname << " does not contain any edges" << std::endl;
+        return false;
+    }
+    std::cout << "Parsed " << parse_bytes << " bytes in " << std::setprecision(3) << parse_time << "s ("
+        << (static_cast<double>(parse_bytes) / 1e9 / parse_time) << " GB/s)" << std::endl;
+    using unmanaged_vtx_t = Kokkos::View<const ordinal_t*, Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+    using unmanaged_wgt_t = Kokkos::View<const scalar_t*, Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+    vtx_vt src_d(Kokkos::ViewAllocateWithoutInitializing("edge sources"), m);
+    vtx_vt dst_d(Kokkos::ViewAllocateWithoutInitializing("edge destinations"), m);
+    wgt_vt wgts_d(Kokkos::ViewAllocateWithoutInitializing("edge weights"), m);
+    Kokkos::deep_copy(src_d, unmanaged_vtx_t(edges.src.data(), m));
+    Kokkos::deep_copy(dst_d, unmanaged_vtx_t(edges.dst.data(), m));
+    Kokkos::deep_copy(wgts_d, unmanaged_wgt_t(edges.wgts.data(), m));
+    edges = edge_triples<ordinal_t, scalar_t>();
+    if(!edge_list_builder<crsMat>::build(n, src_d, dst_d, wgts_d, rule, g, uniform_ew)) return false;
+    std::cout << "Built graph with " << n << " vertices and " << g.nnz() / 2 << " edges from " << m << " input edges" << std::endl;
+    std::cout << "Processed graph at " << fname << " in " << std::setprecision(3) << t.seconds() << "s" << std::endl;
+    return true;
+}
+
+//rule for combining repeated edges in edge list and matrix market files
+//set through the JET_DUPLICATE_RULE environment variable (sum, max or first), sum is the default
+bool duplicate_rule_from_env(duplicate_rule& rule){
+    const char* env = getenv("JET_DUPLICATE_RULE");
+    std::string r = (env == nullptr) ? "sum" : env;
+    if(r == "sum"){
+        rule = duplicate_rule::sum;
+    } else if(r == "max"){
+        rule = duplicate_rule::max;
+    } else if(r == "first"){
+        rule = duplicate_rule::first;
+    } else {
+        std::cerr << "FATAL ERROR: Unknown duplicate edge rule " << r << " (expected sum, max or first)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+enum class text_format { metis, matrix_market, edge_list };
+
+//identifies a text graph format from the file extension, ignoring a trailing .gz or .zst
+//files without a recognized extension are checked for a matrix market banner
+text_format detect_text_format(const char* fname){
+    std::string name(fname);
+    for(const char* z : {".gz", ".zst"}){
+        size_t len = strlen(z);
+        if(name.size() > len && name.compare(name.size() - len, len, z) == 0){
+            name.resize(name.size() - len);
+            break;
+        }
+    }
+    std::string ext;
+    size_t dot = name.find_last_of("./");
+    if(dot != std::string::npos && name[dot] == '.') ext = name.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c){ return std::tolower(c); });
+    if(ext == ".mtx") return text_format::matrix_market;
+    if(ext == ".el" || ext == ".edges" || ext == ".edgelist" || ext == ".tsv" || ext == ".csv") return text_format::edge_list;
+    //only regular files are checked so that no input is consumed from pipes
+    struct stat st;
+    if(stat(fname, &st) != 0 || !S_ISREG(st.st_mode)) return text_format::metis;
+    char banner[14];
+    FILE* fp = fopen(fname, "rb");
+    if(fp == nullptr) return text_format::metis;
+    size_t r = fread(banner, 1, sizeof(banner), fp);
+    fclose(fp);
+    if(r == sizeof(banner) && strncmp(banner, "%%MatrixMarket", sizeof(banner)) == 0) return text_format::matrix_market;
+    return text_format::metis;
+}
+
+//loads a graph from any supported text format
+template<class crsMat>
+bool load_text_graph(crsMat& g, bool& uniform_ew, const char *fname) {
+    text_format fmt = detect_text_format(fname);
+    if(fmt == text_format::metis){
+        return load_metis_graph(g, uniform_ew, fname);
+    }
+    duplicate_rule rule = duplicate_rule::sum;
+    if(!duplicate_rule_from_env(rule)) return false;
+    return load_edge_list(g, uniform_ew, fname, fmt == text_format::matrix_market, rule);
+}
+
+//loads either a binary graph or a text graph depending on the file contents
+//names of the form shm:<name> attach to a graph published in shared memory
+//vertex weights are set to 1 unless the file provides them
+//shared and binary graphs may be used in place from their mapping, which is kept in mapping if given
+//and must then outlive g and vweights
+//without a mapping, it stays for the life of the process, since views of it may be held anywhere
+std::list<mapped_file>& shared_mappings(){
+    static std::list<mapped_file> mappings;
+    return mappings;
+}
+
+template<class crsMat, class wgt_view_t>
+bool load_graph(crsMat& g, wgt_view_t& vweights, bool& uniform_ew, const char *fname, mapped_file* mapping = nullptr) {
+    if(is_shared_graph_name(fname)){
+        if(mapping == nullptr) mapping = &shared_mappings().emplace_back();
+        return binary_graph<crsMat>::attach_graph(fname, g, vweights, uniform_ew, *mapping);
+    }
+    if(is_binary_graph(fname)){
+        if(mapping == nullptr) mapping = &shared_mappings().emplace_back();
+        return binary_graph<crsMat>::load_graph(fname, g, vweights, uniform_ew, *mapping);
+    }
+    if(!load_text_graph(g, uniform_ew, fname)) return false;
+    vweights = wgt_view_t("vertex weights", g.numRows());
+    Kokkos::deep_copy(vweights, 1);
+    return true;
+}
+
+//integer widths needed to hold a graph
+//standard is matrix_t, big is big_matrix_t and biggest is biggest_matrix_t
+enum class graph_size { standard, big, biggest };
+
+graph_size graph_size_for(uint64_t n, uint64_t nnz){
+    const uint64_t limit = std::numeric_limits<int32_t>::max();
+    if(n > limit) return graph_size::biggest;
+    if(nnz > limit) return graph_size::big;
+    return graph_size::standard;
+}
+
+//chooses the graph types for a file by inspecting its header
+//binary graphs also use the widths they were written with
+//edge lists have no header, so their edge count is bounded from the file size (4 bytes per line at least)
+//inputs that can't be inspected without consuming them (pipes) are assumed to be standard
+//the JET_GRAPH_SIZE environment variable (standard, big or biggest) overrides the choice
+bool probe_graph_size(const char* fname, graph_size& size){
+    size = graph_size::standard;
+    const char* env = getenv("JET_GRAPH_SIZE");
+    if(env != nullptr){
+        std::string r = env;
+        if(r == "standard"){
+            size = graph_size::standard;
+        } else if(r == "big"){
+            size = graph_size::big;
+        } else if(r == "biggest"){
+            size = graph_size::biggest;
+        } else {
+            std::cerr << "FATAL ERROR: Unknown graph size " << r << " (expected standard, big or biggest)" << std::endl;
+            return false;
+        }
+        return true;
+    }
+    bool shared = is_shared_graph_name(fname);
+    struct stat st;
+    if(!shared && (stat(fname, &st) != 0 || !S_ISREG(st.st_mode))) return true;
+    if(shared || is_binary_graph(fname)){
+        mapped_file f;
+        binary_graph_header h;
+        bool opened = shared ? f.open_shared(shared_object_name(fname).c_str()) : f.open(fname);
+        if(!opened || !read_binary_graph_header(f, h)) return true;
+        size = graph_size_for(h.n, h.nnz);
+        if(h.ordinal_width == 8){
+            size = graph_size::biggest;
+        } else if(size == graph_size::standard && (h.offset_width == 8 || h.value_width == 8)){
+            size = graph_size::big;
+        }
+        return true;
+    }
+    text_format fmt = detect_text_format(fname);
+    if(fmt == text_format::edge_list){
+        if(detect_compression(fname) == compression::none){
+            size = graph_size_for(0, static_cast<uint64_t>(st.st_size) / 2);
+        }
+        return true;
+    }
+    //only the first window of the file is read
+    std::unique_ptr<line_source> src = open_line_source(fname, static_cast<size_t>(1) << 20);
+    if(src == nullptr) return true;
+    const char* f = nullptr;
+    const char* end = nullptr;
+    if(fmt == text_format::metis){
+        size_t header[4] = {0, 0, 0, 0};
+        if(read_metis_header(*src, f, end, header)){
+            size = graph_size_for(header[0], 2*static_cast<uint64_t>(header[1]));
+        }
+        return true;
+    }
+    //matrix market: the size line is the first line that isn't a comment
+    if(!src->next(f, end)) return true;
+    while(f < end){
+        const char* next = line_end(f, end);
+        int64_t rows = 0, cols = 0, entries = 0;
+        if(is_edge_line(f)){
+            if(parse_id(f, rows) && parse_id(f, cols) && parse_id(f, entries)){
+                size = graph_size_for(rows, 2*static_cast<uint64_t>(entries));
+            }
+            break;
+        }
+        f = next;
+    }
+    return true;
+}
+
+//binary partition files begin with this header
+//n part ids of id_width bytes each (2 or 4, signed) follow immediately
+struct binary_part_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t id_width;
+    uint64_t n;
+};
+
+static_assert(sizeof(binary_part_header) == 24, "binary partition header must be 24 bytes");
+
+constexpr char binary_part_magic[8] = {'J', 'E', 'T', 'P', 'A', 'R', 'T', '\0'};
+constexpr uint32_t binary_part_version = 1;
+
+//partitions are written in the binary format when the output file name ends in .bin
+bool is_binary_part_name(const char* fname){
+    size_t len = strlen(fname);
+    return len >= 4 && strcmp(fname + len - 4, ".bin") == 0;
+}
+
+//writes all of buf to fd, retrying on partial writes
+bool write_all(int fd, const char* buf, size_t len){
+    while(len > 0){
+        ssize_t w = ::write(fd, buf, len);
+        if(w < 0){
+            if(errno == EINTR) continue;
+            return false;
+        }
+        buf += w;
+        len -= w;
+    }
+    return true;
+}
+
+//vertices formatted per chunk when writing a partition
+constexpr size_t part_write_chunk = static_cast<size_t>(1) << 16;
+
+//formats the ids of part into per-chunk buffers in parallel and writes the buffers in order
+//format(begin, end, out) encodes vertices [begin, end) into out and returns the bytes used
+//only one batch of chunks is held in memory at a time
+template<typename F>
+bool write_part_chunks(int fd, size_t n, size_t max_bytes_per_id, F format){
+    size_t batch = Kokkos::DefaultHostExecutionSpace().concurrency();
+    std::vector<std::vector<char>> bufs(batch, std::vector<char>(part_write_chunk * max_bytes_per_id));
+    std::vector<size_t> lens(batch, 0);
+    for(size_t start = 0; start < n; start += batch * part_write_chunk){
+        size_t chunks = std::min(batch, (n - start + part_write_chunk - 1) / part_write_chunk);
+        Kokkos::parallel_for("format part chunks", host_policy(0, chunks), [&](const size_t i){
+            size_t begin = start + i * part_write_chunk;
+            size_t end = std::min(n, begin + part_write_chunk);
+            lens[i] = format(begin, end, bufs[i].data());
+        });
+        Kokkos::DefaultHostExecutionSpace().fence();
+        for(size_t i = 0; i < chunks; i++){
+            if(!write_all(fd, bufs[i].data(), lens[i])) return false;
+        }
+    }
+    return true;
+}
+
+//writes x followed by a newline and returns the number of characters written
+size_t format_part_id(part_t x, char* out){
+    char digits[24];
+    size_t len = 0;
+    int64_t v = x;
+    bool neg = v < 0;
+    if(neg) v = -v;
+    do {
+        digits[len++] = '0' + (v % 10);
+        v /= 10;
+    } while(v > 0);
+    size_t written = 0;
+    if(neg) out[written++] = '-';
+    while(len > 0) out[written++] = digits[--len];
+    out[written++] = '\n';
+    return written;
+}
+
+//writes one part id per line, or the binary partition format if binary is set
+//binary ids are stored as int16 when every id fits, otherwise as int32
+bool write_part(part_vt part_d, const char *fname, bool binary){
     part_mt part = Kokkos::create_mirror_view(part_d);
     Kokkos::deep_copy(part, part_d);
     size_t n = part.extent(0);
-    std::stringstream ss;
-    for(size_t x = 0; x < n; x++){
-        ss << part(x) << std::endl;
+    int fd = ::open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0){
+        std::cerr << "FATAL ERROR: Could not open partition output file " << fname << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    Kokkos::Timer t;
+    bool ok = true;
+    if(binary){
+        part_t lo = 0, hi = 0;
+        Kokkos::parallel_reduce("part id range", host_policy(0, n), [&](const size_t i, part_t& update){
+            if(part(i) < update) update = part(i);
+        }, Kokkos::Min<part_t>(lo));
+        Kokkos::parallel_reduce("part id range", host_policy(0, n), [&](const size_t i, part_t& update){
+            if(part(i) > update) update = part(i);
+        }, Kokkos::Max<part_t>(hi));
+        bool narrow = (n == 0) || (lo >= std::numeric_limits<int16_t>::lowest() && hi <= std::numeric_limits<int16_t>::max());
+        binary_part_header h;
+        memcpy(h.magic, binary_part_magic, sizeof(h.magic));
+        h.version = binary_part_version;
+        h.id_width = narrow ? sizeof(int16_t) : sizeof(int32_t);
+        h.n = n;
+        ok = write_all(fd, reinterpret_cast<const char*>(&h), sizeof(h));
+        if(ok && narrow){
+            ok = write_part_chunks(fd, n, sizeof(int16_t), [&](size_t begin, size_t end, char* out){
+                int16_t* ids = reinterpret_cast<int16_t*>(out);
+                for(size_t i = begin; i < end; i++) ids[i - begin] = static_cast<int16_t>(part(i));
+                return (end - begin) * sizeof(int16_t);
+            });
+        } else if(ok){
+            ok = write_part_chunks(fd, n, sizeof(int32_t), [&](size_t begin, size_t end, char* out){
+                int32_t* ids = reinterpret_cast<int32_t*>(out);
+                for(size_t i = begin; i < end; i++) ids[i - begin] = static_cast<int32_t>(part(i));
+                return (end - begin) * sizeof(int32_t);
+            });
+        }
+    } else {
+        //an id is at most 11 characters plus a newline
+        ok = write_part_chunks(fd, n, 12, [&](size_t begin, size_t end, char* out){
+            size_t len = 0;
+            for(size_t i = begin; i < end; i++) len += format_part_id(part(i), out + len);
+            return len;
+        });
+    }
+    if(::close(fd) != 0) ok = false;
+    if(!ok){
+        std::cerr << "FATAL ERROR: Error while writing partition file " << fname << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    std::cout << "Wrote partition to " << fname << " in " << std::setprecision(3) << t.seconds() << "s" << std::endl;
+    return true;
+}
+
+bool write_part(part_vt part_d, const char *fname){
+    return write_part(part_d, fname, is_binary_part_name(fname));
+}
+
+//counts the part ids in a chunk of a text partition file
+//must follow the exact same rules as parse_part_chunk
+size_t count_part_chunk(const char* f, const char* fmax){
+    size_t ids = 0;
+    while(f < fmax){
+        if(isdigit(*f)){
+            ids++;
+            while(isdigit(*f)) f++;
+        } else {
+            f++;
+        }
+    }
+    return ids;
+}
+
+//writes the part ids in a chunk starting at vertex offset
+//ids past the end of part are counted but not stored
+//returns the number of invalid characters and ids outside [0, k)
+size_t parse_part_chunk(const char* f, const char* fmax, size_t offset, part_t k, part_mt part){
+    size_t n = part.extent(0);
+    size_t bad = 0;
+    while(f < fmax){
+        if(isdigit(*f)){
+            int64_t x = fast_atoi<int64_t>(f);
+            if(offset < n){
+                if(x >= k){
+                    bad++;
+                } else {
+                    part(offset) = x;
+                }
+            }
+            offset++;
+        } else {
+            if(!isspace(*f)) bad++;
+            f++;
+        }
+    }
+    return bad;
+}
+
+//parses the text partition in [begin, end) in parallel
+//offset is the number of ids preceding this region, bad accumulates errors
+size_t parse_part_body(const char* begin, const char* end, size_t offset, part_t k, part_mt part, size_t& bad){
+    std::vector<const char*> bounds = split_lines(begin, end, 1 << 16);
+    size_t chunks = bounds.size() - 1;
+    std::vector<size_t> offsets(chunks + 1, 0);
+    Kokkos::parallel_for("count part chunks", host_policy(0, chunks), [&](const size_t i){
+        offsets[i + 1] = count_part_chunk(bounds[i], bounds[i + 1]);
+    });
+    Kokkos::DefaultHostExecutionSpace().fence();
+    offsets[0] = offset;
+    for(size_t i = 1; i <= chunks; i++){
+        offsets[i] += offsets[i - 1];
+    }
+    std::vector<size_t> chunk_bad(chunks, 0);
+    Kokkos::parallel_for("parse part chunks", host_policy(0, chunks), [&](const size_t i){
+        chunk_bad[i] = parse_part_chunk(bounds[i], bounds[i + 1], offsets[i], k, part);
+    });
+    Kokkos::DefaultHostExecutionSpace().fence();
+    for(size_t i = 0; i < chunks; i++){
+        bad += chunk_bad[i];
     }
-    ofp << ss.str();
-    ofp.close();
+    return offsets[chunks];
 }
 
-part_vt load_part(ordinal_t n, const char *fname){
-    std::ifstream ifp(fname);
-    part_vt part_d("device part", n);
-    if(!ifp.is_open()) return part_d;
+//reads a partition in the binary format written by write_part
+bool load_binary_part(const mapped_file& f, part_t k, part_mt part, const char* fname){
+    size_t n = part.extent(0);
+    binary_part_header h;
+    memcpy(&h, f.data, sizeof(h));
+    if(h.version != binary_part_version || (h.id_width != sizeof(int16_t) && h.id_width != sizeof(int32_t))){
+        std::cerr << "FATAL ERROR: Unsupported binary partition version " << h.version << " or id width " << h.id_width << std::endl;
+        return false;
+    }
+    if(h.n != n){
+        std::cerr << "FATAL ERROR: Partition file " << fname << " has " << h.n << " vertices but the graph has " << n << std::endl;
+        return false;
+    }
+    if(f.size != sizeof(h) + n * h.id_width){
+        std::cerr << "FATAL ERROR: Binary partition file " << fname << " is " << f.size << " bytes; expected "
+            << (sizeof(h) + n * h.id_width) << std::endl;
+        return false;
+    }
+    const char* ids = f.data + sizeof(h);
+    bool narrow = (h.id_width == sizeof(int16_t));
+    size_t bad = 0;
+    Kokkos::parallel_reduce("read binary part", host_policy(0, n), [&](const size_t i, size_t& update){
+        int64_t x = narrow ? reinterpret_cast<const int16_t*>(ids)[i] : reinterpret_cast<const int32_t*>(ids)[i];
+        if(x < 0 || x >= k){
+            update++;
+        } else {
+            part(i) = x;
+        }
+    }, bad);
+    if(bad > 0){
+        std::cerr << "FATAL ERROR: " << bad << " part ids in " << fname << " are outside [0, " << k << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//loads a partition of n vertices into k parts from a text or binary partition file
+//text files contain whitespace separated part ids and are parsed in parallel like graph files
+//binary files are detected by their header
+bool load_part(part_vt& part_d, size_t n, part_t k, const char *fname){
+    Kokkos::Timer t;
+    part_d = part_vt(Kokkos::ViewAllocateWithoutInitializing("device part"), n);
     part_mt part = Kokkos::create_mirror_view(part_d);
-    for(ordinal_t x = 0; x < n; x++){
-        ifp >> part(x);
+    mapped_file f;
+    if(f.open(fname) && f.size >= sizeof(binary_part_header) && memcmp(f.data, binary_part_magic, sizeof(binary_part_magic)) == 0){
+        if(!load_binary_part(f, k, part, fname)) return false;
+    } else {
+        f.close();
+        std::unique_ptr<line_source> src = open_line_source(fname, io_limit());
+        if(src == nullptr){
+            std::cerr << "FATAL ERROR: Could not open partition file " << fname << std::endl;
+            return false;
+        }
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        size_t ids = 0;
+        size_t bad = 0;
+        while(src->next(begin, end)){
+            ids = parse_part_body(begin, end, ids, k, part, bad);
+        }
+        if(src->failed){
+            std::cerr << "FATAL ERROR: Error while reading partition file " << fname << std::endl;
+            return false;
+        }
+        if(ids != static_cast<size_t>(n)){
+            std::cerr << "FATAL ERROR: Partition file " << fname << " has " << ids << " part ids but the graph has " << n << " vertices" << std::endl;
+            return false;
+        }
+        if(bad > 0){
+            std::cerr << "FATAL ERROR: Partition file " << fname << " contains " << bad << " entries that are not part ids in [0, " << k << ")" << std::endl;
+            return false;
+        }
     }
-    ifp.close();
     Kokkos::deep_copy(part_d, part);
-    return part_d;
+    std::cout << "Loaded partition from " << fname << " in " << std::setprecision(3) << t.seconds() << "s" << std::endl;
+    return true;
 }
 
 };
\ No newline at end of file
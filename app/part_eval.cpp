@@ -43,73 +43,79 @@
 
 using namespace jet_partitioner;
 
+template<class crsMat>
+int evaluate(const char* filename, const char* part_file, part_t k){
+    using scalar_t = typename crsMat::value_type;
+    using wgt_view_t = Kokkos::View<scalar_t*, Device>;
+    crsMat g;
+    wgt_view_t vweights;
+    bool uniform_ew = false;
+    if(!load_graph(g, vweights, uniform_ew, filename)) return -1;
+    std::cout << "vertices: " << g.numRows() << "; edges: " << g.nnz() / 2 << std::endl;
+
+    part_vt part;
+    if(!load_part(part, g.numRows(), k, part_file)) return -1;
+    using stat = part_stat<crsMat, part_t>;
+    using gain_t = typename stat::gain_t;
+    using gain_vt = typename stat::gain_vt;
+    scalar_t cut = stat::get_total_cut(g, part);
+    //the per-part cut needs k entries instead of the k*k of cut_heatmap
+    gain_t max = stat::max_part_cut(g, part, k);
+    std::cout << "Max part cut: " << max << std::endl;
+    cut = cut / 2;
+    std::cout << "Cutsize: " << cut << std::endl;
+    scalar_t comm_size = stat::comm_size(g, part, k);
+    std::cout << "Comm size: " << comm_size << std::endl;
+    gain_vt part_sizes = stat::get_part_sizes(g, vweights, part, k);
+    typename gain_vt::HostMirror ps_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), part_sizes);
+    gain_t largest = 0;
+    gain_t total = 0;
+    gain_t smallest = std::numeric_limits<gain_t>::max();
+    for(int p = 0; p < k; p++){
+        total += ps_host(p);
+        if(ps_host(p) > largest){
+            largest = ps_host(p);
+        }
+        if(ps_host(p) < smallest){
+            smallest = ps_host(p);
+        }
+    }
+    double opt = stat::optimal_size(total, k);
+    double max_imb = static_cast<double>(largest) / opt;
+    double min_imb = static_cast<double>(smallest) / opt;
+    std::cout << std::setprecision(5);
+    std::cout << "Largest: " << max_imb << std::endl;
+    std::cout << "Smallest: " << min_imb << std::endl;
+    return 0;
+}
+
 int main(int argc, char **argv) {
 
     if (argc < 4) {
         std::cerr << "Insufficient number of args provided" << std::endl;
-        std::cerr << "Usage: " << argv[0] << " <metis_graph_file> <part_file> <k>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <graph_file> <part_file> <k>" << std::endl;
         return -1;
     }
     char *filename = argv[1];
     char *part_file = argv[2];
     part_t k = atoi(argv[3]);
 
+    //graphs too large for 32-bit offsets or ids are loaded into the 64-bit types
+    graph_size size = graph_size::standard;
+    if(!probe_graph_size(filename, size)) return -1;
+
     Kokkos::initialize();
     //must scope kokkos-related data
     //so that it falls out of scope b4 finalize
-    {
-        matrix_t g;
-        bool uniform_ew = false;
-        if(!load_metis_graph(g, uniform_ew, filename)) return -1;
-        std::cout << "vertices: " << g.numRows() << "; edges: " << g.nnz() / 2 << std::endl;
-        wgt_vt vweights("vertex weights", g.numRows());
-        Kokkos::deep_copy(vweights, 1);
-
-        part_vt part = load_part(g.numRows(), part_file);
-        using stat = part_stat<matrix_t, part_t>; 
-        using h_t = stat::gain_2vt;
-        using gain_t = stat::gain_t;
-        using gain_vt = stat::gain_vt;
-        value_t cut = stat::get_total_cut(g, part);
-        h_t heatmap_d = stat::cut_heatmap(g, part, k);
-        h_t::HostMirror heatmap = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), heatmap_d);
-        std::vector<std::vector<gain_t>> hvec(k, std::vector<gain_t>(k, 0));
-        gain_t max = 0;
-        for(part_t i = 0; i < k; i++){
-            gain_t row_total = 0;
-            for(part_t j = 0; j < k; j++){
-                hvec[i][j] = heatmap(i, j);
-                row_total += heatmap(i, j);
-            }
-            max = max > row_total ? max : row_total;
-        }
-        std::cout << "Max part cut: " << max << std::endl;
-        cut = cut / 2;
-        std::cout << "Cutsize: " << cut << std::endl;
-        value_t comm_size = stat::comm_size(g, part, k);
-        std::cout << "Comm size: " << comm_size << std::endl;
-        gain_vt part_sizes = stat::get_part_sizes(g, vweights, part, k);
-        typename gain_vt::HostMirror ps_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), part_sizes);
-        gain_t largest = 0;
-        gain_t total = 0;
-        gain_t smallest = g.numRows();
-        for(int p = 0; p < k; p++){
-            total += ps_host(p);
-            if(ps_host(p) > largest){
-                largest = ps_host(p);
-            }
-            if(ps_host(p) < smallest){
-                smallest = ps_host(p);
-            }
-        }
-        double opt = stat::optimal_size(total, k);
-        double max_imb = static_cast<double>(largest) / opt;
-        double min_imb = static_cast<double>(smallest) / opt;
-        std::cout << std::setprecision(5);
-        std::cout << "Largest: " << max_imb << std::endl;
-        std::cout << "Smallest: " << min_imb << std::endl;
+    int ret = 0;
+    if(size == graph_size::biggest){
+        ret = evaluate<biggest_matrix_t>(filename, part_file, k);
+    } else if(size == graph_size::big){
+        ret = evaluate<big_matrix_t>(filename, part_file, k);
+    } else {
+        ret = evaluate<matrix_t>(filename, part_file, k);
     }
     Kokkos::finalize();
 
-    return 0;
+    return ret;
 }
@@ -0,0 +1,426 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#include "jet_defs.h"
+#include "io.hpp"
+#include "jet.h"
+#include "jet_config.h"
+#include <list>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace jet_partitioner;
+
+//a graph kept loaded between requests, only the members for its size are set
+struct resident_graph {
+    //binary and shared graphs may be used in place from this mapping
+    //it is declared first so that it is unmapped after the views of it are released
+    mapped_file mapping;
+    graph_size size = graph_size::standard;
+    matrix_t g;
+    wgt_vt vweights;
+    big_matrix_t big_g;
+    big_wgt_vt big_vweights;
+    biggest_matrix_t biggest_g;
+    big_wgt_vt biggest_vweights;
+    bool uniform_ew = false;
+    //a changed file is reloaded
+    dev_t device = 0;
+    ino_t inode = 0;
+    off_t bytes = 0;
+    time_t modified = 0;
+};
+
+//holds the most recently used graphs, the least recently used graph is dropped when the cache is full
+class graph_cache {
+public:
+    using entry_t = std::pair<std::string, std::shared_ptr<resident_graph>>;
+
+    size_t capacity = 4;
+    size_t hits = 0;
+    size_t misses = 0;
+    //most recently used first
+    std::list<entry_t> order;
+    std::map<std::string, std::list<entry_t>::iterator> index;
+
+    //returns the graph loaded from path, loading it unless a current copy is cached
+    std::shared_ptr<resident_graph> get(const std::string& path, bool& cached, std::string& error){
+        //the mapping of a shared graph stays valid even if it is republished, so it is only reattached after an evict
+        struct stat st;
+        memset(&st, 0, sizeof(st));
+        if(!is_shared_graph_name(path.c_str()) && stat(path.c_str(), &st) != 0){
+            error = "could not stat " + path;
+            return nullptr;
+        }
+        auto it = index.find(path);
+        if(it != index.end()){
+            std::shared_ptr<resident_graph> r = it->second->second;
+            if(r->device == st.st_dev && r->inode == st.st_ino && r->bytes == st.st_size && r->modified == st.st_mtime){
+                order.splice(order.begin(), order, it->second);
+                hits++;
+                cached = true;
+                return r;
+            }
+            evict(path);
+        }
+        misses++;
+        cached = false;
+        std::shared_ptr<resident_graph> r = std::make_shared<resident_graph>();
+        if(!probe_graph_size(path.c_str(), r->size)){
+            error = "could not read " + path;
+            return nullptr;
+        }
+        bool loaded = false;
+        if(r->size == graph_size::biggest){
+            loaded = load_graph(r->biggest_g, r->biggest_vweights, r->uniform_ew, path.c_str(), &r->mapping);
+        } else if(r->size == graph_size::big){
+            loaded = load_graph(r->big_g, r->big_vweights, r->uniform_ew, path.c_str(), &r->mapping);
+        } else {
+            loaded = load_graph(r->g, r->vweights, r->uniform_ew, path.c_str(), &r->mapping);
+        }
+        if(!loaded){
+            error = "could not load " + path;
+            return nullptr;
+        }
+        r->device = st.st_dev;
+        r->inode = st.st_ino;
+        r->bytes = st.st_size;
+        r->modified = st.st_mtime;
+        order.emplace_front(path, r);
+        index[path] = order.begin();
+        while(order.size() > capacity){
+            evict(order.back().first);
+        }
+        return r;
+    }
+
+    bool evict(const std::string& path){
+        auto it = index.find(path);
+        if(it == index.end()) return false;
+        order.erase(it->second);
+        index.erase(it);
+        return true;
+    }
+
+    void clear(){
+        index.clear();
+        order.clear();
+    }
+};
+
+//selects the library entry point matching the graph types and build target
+part_vt run_partition(value_t& edgecut, const config_t& config, const matrix_t& g, const wgt_vt& vweights,
+    bool uniform_ew, experiment_data<value_t>& experiment, context& ctx){
+#ifdef HOST
+    return partition_host(edgecut, config, g, vweights, uniform_ew, experiment, Device(), &ctx);
+#elif defined SERIAL
+    return partition_serial(edgecut, config, g, vweights, uniform_ew, experiment, Device(), &ctx);
+#else
+    return partition(edgecut, config, g, vweights, uniform_ew, experiment, Device(), &ctx);
+#endif
+}
+
+part_vt run_partition(big_val_t& edgecut, const config_t& config, const big_matrix_t& g, const big_wgt_vt& vweights,
+    bool uniform_ew, experiment_data<big_val_t>& experiment, context& ctx){
+#ifdef HOST
+    return partition_host_big(edgecut, config, g, vweights, uniform_ew, experiment, Device(), &ctx);
+#elif defined SERIAL
+    return partition_serial_big(edgecut, config, g, vweights, uniform_ew, experiment, Device(), &ctx);
+#else
+    return partition_big(edgecut, config, g, vweights, uniform_ew, experiment, Device(), &ctx);
+#endif
+}
+
+part_vt run_partition(big_val_t& edgecut, const config_t& config, const biggest_matrix_t& g, const big_wgt_vt& vweights,
+    bool uniform_ew, experiment_data<big_val_t>& experiment, context& ctx){
+#ifdef HOST
+    return partition_host_biggest(edgecut, config, g, vweights, uniform_ew, experiment, Device(), &ctx);
+#elif defined SERIAL
+    return partition_serial_biggest(edgecut, config, g, vweights, uniform_ew, experiment, Device(), &ctx);
+#else
+    return partition_biggest(edgecut, config, g, vweights, uniform_ew, experiment, Device(), &ctx);
+#endif
+}
+
+bool respond(int fd, const std::string& msg){
+    return write_all(fd, msg.data(), msg.size());
+}
+
+//replies with "ok <vertices> <edgecut> <cached>", a line of json metrics, and then the part of each vertex as raw part_t values
+template<class crsMat, class wgt_view_t>
+bool respond_partition(int fd, const crsMat& g, const wgt_view_t& vweights, bool uniform_ew, const config_t& config, context& ctx, bool cached){
+    using scalar_t = typename crsMat::value_type;
+    experiment_data<scalar_t> experiment;
+    scalar_t edgecut = 0;
+    part_vt part = run_partition(edgecut, config, g, vweights, uniform_ew, experiment, ctx);
+    auto part_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), part);
+    std::ostringstream header;
+    header << "ok " << part_h.extent(0) << " " << edgecut << " " << (cached ? 1 : 0) << "\n";
+    experiment.writeJson(header);
+    header << "\n";
+    return respond(fd, header.str()) && write_all(fd, reinterpret_cast<const char*>(part_h.data()), part_h.extent(0)*sizeof(part_t));
+}
+
+//applies key=value fields of a request to config
+bool parse_fields(config_t& config, std::istringstream& request, std::string& error){
+    std::string field;
+    while(request >> field){
+        size_t eq = field.find('=');
+        if(eq == std::string::npos){
+            error = "expected key=value, got " + field;
+            return false;
+        }
+        std::string key = field.substr(0, eq);
+        const char* value = field.c_str() + eq + 1;
+        char* end = nullptr;
+        if(key == "k"){
+            config.num_parts = strtol(value, &end, 10);
+        } else if(key == "imb"){
+            config.max_imb_ratio = strtod(value, &end);
+        } else if(key == "alg"){
+            config.coarsening_alg = strtol(value, &end, 10);
+        } else if(key == "seed"){
+            config.seed = strtoull(value, &end, 10);
+        } else if(key == "ultra"){
+            config.ultra_settings = strtol(value, &end, 10) != 0;
+        } else if(key == "tol"){
+            config.refine_tolerance = strtod(value, &end);
+        } else if(key == "time_limit"){
+            double limit = strtod(value, &end);
+            if(limit > 0) config.deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(limit));
+        } else if(set_config_field(config, key, field.substr(eq + 1), error)){
+            //any other config key, see load_config
+            continue;
+        } else {
+            return false;
+        }
+        if(end == value || *end != '\0'){
+            error = "invalid value for " + key;
+            return false;
+        }
+    }
+    if(config.num_parts < 1){
+        error = "k must be positive";
+        return false;
+    }
+    return true;
+}
+
+//seconds a reply may wait on a client that does not read it
+constexpr time_t send_timeout_seconds = 30;
+
+//longest request line accepted, a client exceeding it is disconnected
+constexpr size_t max_request_bytes = 1 << 16;
+
+//a client connection and the bytes it sent past its last complete request
+struct client {
+    int fd;
+    std::string buffer;
+};
+
+//serves one request line, returns false if the connection should be closed
+//shutdown is set when the client asks the server to stop
+bool serve(int fd, const std::string& line, graph_cache& cache, const config_t& base_config, context& ctx, bool& shutdown){
+    std::istringstream request(line);
+    std::string command, path;
+    request >> command;
+    if(command == "partition" && request >> path){
+        config_t config = base_config;
+        std::string error;
+        bool cached = false;
+        std::shared_ptr<resident_graph> r;
+        if(parse_fields(config, request, error)) r = cache.get(path, cached, error);
+        if(r == nullptr){
+            return respond(fd, "error " + error + "\n");
+        }
+        if(r->size == graph_size::biggest){
+            return respond_partition(fd, r->biggest_g, r->biggest_vweights, r->uniform_ew, config, ctx, cached);
+        } else if(r->size == graph_size::big){
+            return respond_partition(fd, r->big_g, r->big_vweights, r->uniform_ew, config, ctx, cached);
+        } else {
+            return respond_partition(fd, r->g, r->vweights, r->uniform_ew, config, ctx, cached);
+        }
+    } else if(command == "evict" && request >> path){
+        return respond(fd, cache.evict(path) ? "ok\n" : "error not cached\n");
+    } else if(command == "stats"){
+        std::ostringstream out;
+        out << "ok " << cache.order.size() << " " << cache.hits << " " << cache.misses << "\n";
+        return respond(fd, out.str());
+    } else if(command == "shutdown"){
+        respond(fd, "ok\n");
+        shutdown = true;
+        return false;
+    }
+    return respond(fd, "error unknown request\n");
+}
+
+//reads what a readable client sent and serves its complete requests in order
+//returns false if the connection should be closed
+bool receive(client& c, graph_cache& cache, const config_t& config, context& ctx, bool& shutdown){
+    char chunk[4096];
+    ssize_t r = ::read(c.fd, chunk, sizeof(chunk));
+    if(r < 0 && errno == EINTR) return true;
+    if(r <= 0) return false;
+    c.buffer.append(chunk, r);
+    size_t nl = c.buffer.find('\n');
+    while(nl != std::string::npos){
+        std::string line = c.buffer.substr(0, nl);
+        c.buffer.erase(0, nl + 1);
+        if(!serve(c.fd, line, cache, config, ctx, shutdown)) return false;
+        nl = c.buffer.find('\n');
+    }
+    return c.buffer.size() <= max_request_bytes;
+}
+
+int run(const char* socket_path, const config_t& config, size_t capacity){
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener < 0){
+        std::cerr << "FATAL ERROR: Could not create socket" << std::endl;
+        return -1;
+    }
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(strlen(socket_path) >= sizeof(addr.sun_path)){
+        std::cerr << "FATAL ERROR: Socket path " << socket_path << " is too long" << std::endl;
+        close(listener);
+        return -1;
+    }
+    strcpy(addr.sun_path, socket_path);
+    //a stale socket from an earlier run is replaced, anything else at the path is left alone
+    struct stat st;
+    if(lstat(socket_path, &st) == 0){
+        if(!S_ISSOCK(st.st_mode)){
+            std::cerr << "FATAL ERROR: " << socket_path << " exists and is not a socket" << std::endl;
+            close(listener);
+            return -1;
+        }
+        unlink(socket_path);
+    }
+    //only the owner may connect, as any client can read files through the server or shut it down
+    mode_t old_mask = umask(0077);
+    bool bound = bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    umask(old_mask);
+    if(!bound || chmod(socket_path, 0600) != 0 || listen(listener, 16) != 0){
+        std::cerr << "FATAL ERROR: Could not listen on " << socket_path << std::endl;
+        close(listener);
+        return -1;
+    }
+    std::cout << "listening on " << socket_path << std::endl;
+    graph_cache cache;
+    cache.capacity = capacity;
+    context ctx;
+    //connections are multiplexed so an idle client cannot block others
+    //requests are still served one at a time, as they share the cache and the context
+    std::vector<client> clients;
+    std::vector<pollfd> fds;
+    bool shutdown = false;
+    while(!shutdown){
+        fds.assign(1, pollfd{listener, POLLIN, 0});
+        for(const client& c : clients){
+            fds.push_back(pollfd{c.fd, POLLIN, 0});
+        }
+        if(poll(fds.data(), fds.size(), -1) < 0){
+            if(errno == EINTR) continue;
+            std::cerr << "FATAL ERROR: Could not wait for connections" << std::endl;
+            break;
+        }
+        //walk backwards so closed clients can be removed in place
+        for(size_t i = clients.size(); i > 0 && !shutdown; i--){
+            if(fds[i].revents == 0) continue;
+            if(!receive(clients[i - 1], cache, config, ctx, shutdown)){
+                close(clients[i - 1].fd);
+                clients.erase(clients.begin() + (i - 1));
+            }
+        }
+        if(!shutdown && (fds[0].revents & POLLIN)){
+            int fd = accept(listener, nullptr, nullptr);
+            if(fd >= 0){
+                //a client that stops reading its reply is dropped instead of stalling the server
+                timeval timeout{send_timeout_seconds, 0};
+                setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                clients.push_back(client{fd, std::string()});
+            } else if(errno != EINTR && errno != ECONNABORTED){
+                std::cerr << "FATAL ERROR: Could not accept connections" << std::endl;
+                break;
+            }
+        }
+    }
+    for(const client& c : clients){
+        close(c.fd);
+    }
+    close(listener);
+    unlink(socket_path);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+
+    if (argc < 3) {
+        std::cerr << "Insufficient number of args provided" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <socket_path> <config_file> <optional cached_graph_count>" << std::endl;
+        return -1;
+    }
+    config_t config;
+    if(!load_config(config, argv[2])) return -1;
+    size_t capacity = 4;
+    if(argc >= 4){
+        capacity = std::max(1, atoi(argv[3]));
+    }
+    config.verbose = false;
+    config.hierarchy_cache_dir = getenv("JET_HIERARCHY_CACHE");
+    //a closed client connection must not end the server
+    signal(SIGPIPE, SIG_IGN);
+
+    Kokkos::initialize();
+    //must scope kokkos-related data
+    //so that it falls out of scope b4 finalize
+    int ret = run(argv[1], config, capacity);
+    Kokkos::finalize();
+
+    return ret;
+}
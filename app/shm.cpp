@@ -0,0 +1,100 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#include "jet_defs.h"
+#include "io.hpp"
+#include "binary_graph.hpp"
+#include <cstring>
+
+using namespace jet_partitioner;
+
+template<class crsMat>
+int publish(const char* filename, const char* name){
+    using scalar_t = typename crsMat::value_type;
+    crsMat g;
+    Kokkos::View<scalar_t*, Device> vweights;
+    bool uniform_ew = false;
+    if(!load_graph(g, vweights, uniform_ew, filename)) return -1;
+    std::cout << "vertices: " << g.numRows() << "; edges: " << g.nnz() / 2 << std::endl;
+    Kokkos::Timer t;
+    if(!binary_graph<crsMat>::publish_graph(name, g, vweights, uniform_ew)) return -1;
+    std::cout << "Published " << filename << " as " << name << " in " << std::setprecision(3) << t.seconds() << "s" << std::endl;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+
+    if (argc < 3 || (strcmp(argv[1], "publish") == 0 && argc < 4)) {
+        std::cerr << "Insufficient number of args provided" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " publish <graph_file> shm:<name>" << std::endl;
+        std::cerr << "       " << argv[0] << " remove shm:<name>" << std::endl;
+        return -1;
+    }
+    if(strcmp(argv[1], "remove") == 0){
+        return binary_graph<matrix_t>::unpublish_graph(argv[2]) ? 0 : -1;
+    }
+    if(strcmp(argv[1], "publish") != 0){
+        std::cerr << "FATAL ERROR: Unknown command " << argv[1] << " (expected publish or remove)" << std::endl;
+        return -1;
+    }
+    char *filename = argv[2];
+    char *name = argv[3];
+    if(!is_shared_graph_name(name)){
+        std::cerr << "FATAL ERROR: Shared graph names must begin with shm:" << std::endl;
+        return -1;
+    }
+
+    //the published widths decide which graph types attaching processes use
+    graph_size size = graph_size::standard;
+    if(!probe_graph_size(filename, size)) return -1;
+
+    Kokkos::initialize();
+    //must scope kokkos-related data
+    //so that it falls out of scope b4 finalize
+    int ret = 0;
+    if(size == graph_size::biggest){
+        ret = publish<biggest_matrix_t>(filename, name);
+    } else if(size == graph_size::big){
+        ret = publish<big_matrix_t>(filename, name);
+    } else {
+        ret = publish<matrix_t>(filename, name);
+    }
+    Kokkos::finalize();
+
+    return ret;
+}
@@ -0,0 +1,401 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <Kokkos_Core.hpp>
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "mapped_file.hpp"
+
+namespace jet_partitioner {
+
+//on-disk layout of a binary csr graph
+//each array begins at an offset that is a multiple of binary_graph_align
+//type widths are in bytes and may be 4 or 8 (signed integers)
+struct binary_graph_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t ordinal_width;
+    uint32_t offset_width;
+    uint32_t value_width;
+    uint32_t reserved;
+    uint64_t n;
+    //number of stored nonzeros (twice the number of undirected edges)
+    uint64_t nnz;
+    uint64_t row_map_offset;
+    uint64_t entries_offset;
+    uint64_t values_offset;
+    uint64_t vwgt_offset;
+};
+static_assert(sizeof(binary_graph_header) == 80, "binary graph header must be 80 bytes");
+
+inline constexpr char binary_graph_magic[8] = {'J', 'E', 'T', 'C', 'S', 'R', '\0', '\0'};
+inline constexpr uint32_t binary_graph_version = 1;
+inline constexpr uint64_t binary_graph_align = 64;
+//every edge weight is 1 and the values array is omitted
+inline constexpr uint32_t binary_graph_uniform_ew = 1;
+//the vertex weights array is present
+inline constexpr uint32_t binary_graph_has_vwgt = 2;
+//every edge weight is 1 but the values array is stored anyway, so that it can be used in place
+inline constexpr uint32_t binary_graph_unit_ew_stored = 4;
+
+//checks magic bytes, so that callers can choose between binary and text loaders
+inline bool is_binary_graph(const char* fname){
+    FILE* fp = fopen(fname, "rb");
+    if(fp == nullptr) return false;
+    char magic[8];
+    bool match = (fread(magic, 1, 8, fp) == 8) && (memcmp(magic, binary_graph_magic, 8) == 0);
+    fclose(fp);
+    return match;
+}
+
+//graphs published in POSIX shared memory are named shm:<object name>
+inline bool is_shared_graph_name(const char* fname){
+    return strncmp(fname, "shm:", 4) == 0;
+}
+
+//the shm_open name of a shared graph, which must begin with a slash
+inline std::string shared_object_name(const char* fname){
+    std::string name = fname + 4;
+    if(name.empty() || name[0] != '/') name = "/" + name;
+    return name;
+}
+
+//reads and validates the header of a mapped binary graph
+inline bool read_binary_graph_header(const mapped_file& f, binary_graph_header& h){
+    if(f.size < sizeof(binary_graph_header)) return false;
+    memcpy(&h, f.data, sizeof(binary_graph_header));
+    if(memcmp(h.magic, binary_graph_magic, 8) != 0) return false;
+    if(h.version != binary_graph_version) return false;
+    for(uint32_t w : {h.ordinal_width, h.offset_width, h.value_width}){
+        if(w != 4 && w != 8) return false;
+    }
+    //every array present must be aligned and lie within the file
+    auto in_file = [&](uint64_t offset, uint64_t count, uint32_t width){
+        return (offset % binary_graph_align == 0) && offset <= f.size && count <= (f.size - offset) / width;
+    };
+    bool valid = in_file(h.row_map_offset, h.n + 1, h.offset_width) && in_file(h.entries_offset, h.nnz, h.ordinal_width);
+    if(!(h.flags & binary_graph_uniform_ew) || (h.flags & binary_graph_unit_ew_stored)) valid = valid && in_file(h.values_offset, h.nnz, h.value_width);
+    if(h.flags & binary_graph_has_vwgt) valid = valid && in_file(h.vwgt_offset, h.n, h.value_width);
+    return valid;
+}
+
+template<class crsMat>
+class binary_graph {
+public:
+    // define internal types
+    using matrix_t = crsMat;
+    using Device = typename matrix_t::device_type;
+    using ordinal_t = typename matrix_t::ordinal_type;
+    using edge_offset_t = typename matrix_t::size_type;
+    using scalar_t = typename matrix_t::value_type;
+    using vtx_vt = Kokkos::View<ordinal_t*, Device>;
+    using edge_vt = Kokkos::View<edge_offset_t*, Device>;
+    using wgt_vt = Kokkos::View<scalar_t*, Device>;
+    using graph_t = typename matrix_t::staticcrsgraph_type;
+    using host_policy = Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>;
+
+//converts count values of type S stored at src into the host mirror dst
+//returns false if any value does not fit in T
+template<typename S, typename T, class mirror_t>
+static bool convert(const char* src, size_t count, mirror_t dst){
+    const S* s = reinterpret_cast<const S*>(src);
+    size_t overflow = 0;
+    Kokkos::parallel_reduce("convert binary graph array", host_policy(0, count), [=](const size_t i, size_t& update){
+        S x = s[i];
+        if(static_cast<int64_t>(x) > static_cast<int64_t>(std::numeric_limits<T>::max())
+            || static_cast<int64_t>(x) < static_cast<int64_t>(std::numeric_limits<T>::lowest())){
+            update++;
+        }
+        dst(i) = static_cast<T>(x);
+    }, overflow);
+    return overflow == 0;
+}
+
+//fills dst with count integers of the given width from the mapped file
+//matching widths are transferred straight from the mapping without an intermediate host copy
+template<typename T>
+static bool read_array(const char* src, uint32_t width, size_t count, Kokkos::View<T*, Device> dst){
+    using unmanaged_t = Kokkos::View<const T*, Kokkos::HostSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+    if(width == sizeof(T)){
+        unmanaged_t src_v(reinterpret_cast<const T*>(src), count);
+        Kokkos::deep_copy(dst, src_v);
+        return true;
+    }
+    auto dst_m = Kokkos::create_mirror_view(dst);
+    bool fits = (width == 4) ? convert<int32_t, T>(src, count, dst_m) : convert<int64_t, T>(src, count, dst_m);
+    if(!fits) return false;
+    Kokkos::deep_copy(dst, dst_m);
+    return true;
+}
+
+//checks that a graph with the counts of h fits the types of matrix_t
+static bool fits_types(const binary_graph_header& h, const char* fname){
+    if(h.n > static_cast<uint64_t>(std::numeric_limits<ordinal_t>::max())
+        || h.nnz > static_cast<uint64_t>(std::numeric_limits<edge_offset_t>::max())){
+        std::cerr << "FATAL ERROR: Graph in " << fname << " with " << h.n << " vertices and " << h.nnz
+            << " nonzeros is too large for the requested graph types" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//copies the arrays of a mapped binary graph into new views
+static bool copy_mapped(const mapped_file& f, const binary_graph_header& h, const char* fname, matrix_t& g, wgt_vt& vweights, bool& uniform_ew){
+    ordinal_t n = h.n;
+    edge_offset_t nnz = h.nnz;
+    edge_vt row_map(Kokkos::ViewAllocateWithoutInitializing("row map"), n + 1);
+    vtx_vt entries(Kokkos::ViewAllocateWithoutInitializing("entries"), nnz);
+    wgt_vt values(Kokkos::ViewAllocateWithoutInitializing("values"), nnz);
+    vweights = wgt_vt(Kokkos::ViewAllocateWithoutInitializing("vertex weights"), n);
+    bool ok = read_array<edge_offset_t>(f.data + h.row_map_offset, h.offset_width, n + 1, row_map);
+    ok = ok && read_array<ordinal_t>(f.data + h.entries_offset, h.ordinal_width, nnz, entries);
+    uniform_ew = (h.flags & binary_graph_uniform_ew);
+    if(uniform_ew){
+        Kokkos::deep_copy(values, 1);
+    } else {
+        ok = ok && read_array<scalar_t>(f.data + h.values_offset, h.value_width, nnz, values);
+    }
+    if(h.flags & binary_graph_has_vwgt){
+        ok = ok && read_array<scalar_t>(f.data + h.vwgt_offset, h.value_width, n, vweights);
+    } else {
+        Kokkos::deep_copy(vweights, 1);
+    }
+    if(!ok){
+        std::cerr << "FATAL ERROR: Weights in " << fname << " do not fit in the requested graph types" << std::endl;
+        return false;
+    }
+    graph_t g_graph(entries, row_map);
+    g = matrix_t("input graph", n, values, g_graph);
+    return true;
+}
+
+//true if the views of matrix_t can wrap the arrays of a mapped graph with header h without copying them
+//the device must be able to read host memory and the stored widths must match matrix_t
+static bool maps_in_place(const binary_graph_header& h){
+    constexpr bool host_accessible = Kokkos::SpaceAccessibility<Kokkos::HostSpace, typename Device::memory_space>::accessible;
+    return host_accessible && h.offset_width == sizeof(edge_offset_t) && h.ordinal_width == sizeof(ordinal_t) && h.value_width == sizeof(scalar_t);
+}
+
+//wraps the arrays of a mapped graph in unmanaged views, f must outlive g and vweights
+//missing edge or vertex weights are allocated and set to 1
+static void wrap_mapped(const mapped_file& f, const binary_graph_header& h, const char* label, matrix_t& g, wgt_vt& vweights, bool& uniform_ew){
+    using unmanaged = Kokkos::MemoryTraits<Kokkos::Unmanaged>;
+    ordinal_t n = h.n;
+    edge_offset_t nnz = h.nnz;
+    //the mapping is read-only, which is safe because the partitioner never writes to its input graph
+    char* base = const_cast<char*>(f.data);
+    edge_vt row_map = Kokkos::View<edge_offset_t*, Device, unmanaged>(reinterpret_cast<edge_offset_t*>(base + h.row_map_offset), n + 1);
+    vtx_vt entries = Kokkos::View<ordinal_t*, Device, unmanaged>(reinterpret_cast<ordinal_t*>(base + h.entries_offset), nnz);
+    wgt_vt values;
+    uniform_ew = (h.flags & binary_graph_uniform_ew);
+    if(uniform_ew && !(h.flags & binary_graph_unit_ew_stored)){
+        values = wgt_vt(Kokkos::ViewAllocateWithoutInitializing("values"), nnz);
+        Kokkos::deep_copy(values, 1);
+    } else {
+        values = Kokkos::View<scalar_t*, Device, unmanaged>(reinterpret_cast<scalar_t*>(base + h.values_offset), nnz);
+    }
+    if(h.flags & binary_graph_has_vwgt){
+        vweights = Kokkos::View<scalar_t*, Device, unmanaged>(reinterpret_cast<scalar_t*>(base + h.vwgt_offset), n);
+    } else {
+        vweights = wgt_vt(Kokkos::ViewAllocateWithoutInitializing("vertex weights"), n);
+        Kokkos::deep_copy(vweights, 1);
+    }
+    graph_t g_graph(entries, row_map);
+    g = matrix_t(label, n, values, g_graph);
+}
+
+//loads a graph written by write_graph, f receives the mapping and must outlive g and vweights
+//when the arrays can be used in place (see maps_in_place) the views wrap the mapping,
+//otherwise the arrays are copied (and converted if needed) and f is closed
+//vertex weights are set to 1 if the file does not contain them
+static bool load_graph(const char* fname, matrix_t& g, wgt_vt& vweights, bool& uniform_ew, mapped_file& f){
+    Kokkos::Timer t;
+    if(!f.open(fname)){
+        std::cerr << "FATAL ERROR: Could not open binary graph file " << fname << std::endl;
+        return false;
+    }
+    binary_graph_header h;
+    if(!read_binary_graph_header(f, h)){
+        std::cerr << "FATAL ERROR: " << fname << " is not a valid binary graph file" << std::endl;
+        return false;
+    }
+    if(!fits_types(h, fname)) return false;
+    if(maps_in_place(h)){
+        wrap_mapped(f, h, "input graph", g, vweights, uniform_ew);
+        std::cout << "Mapped binary graph " << fname << " (" << f.size << " bytes) in " << std::setprecision(3) << t.seconds() << "s" << std::endl;
+        return true;
+    }
+    f.advise_sequential();
+    bool ok = copy_mapped(f, h, fname, g, vweights, uniform_ew);
+    f.close();
+    if(!ok) return false;
+    std::cout << "Loaded binary graph " << fname << " (" << h.nnz << " nonzeros) in " << std::setprecision(3) << t.seconds() << "s" << std::endl;
+    return true;
+}
+
+//attaches to a graph published by publish_graph, f receives the mapping and must outlive g and vweights
+//the arrays are used in place when possible (see maps_in_place), otherwise they are copied (and converted if needed)
+//missing edge or vertex weights are allocated and set to 1, graphs published by publish_graph store both
+static bool attach_graph(const char* fname, matrix_t& g, wgt_vt& vweights, bool& uniform_ew, mapped_file& f){
+    Kokkos::Timer t;
+    if(!f.open_shared(shared_object_name(fname).c_str())){
+        std::cerr << "FATAL ERROR: Could not attach shared graph " << fname << std::endl;
+        return false;
+    }
+    binary_graph_header h;
+    if(!read_binary_graph_header(f, h)){
+        std::cerr << "FATAL ERROR: " << fname << " is not a valid shared graph" << std::endl;
+        return false;
+    }
+    if(!fits_types(h, fname)) return false;
+    if(!maps_in_place(h)){
+        if(!copy_mapped(f, h, fname, g, vweights, uniform_ew)) return false;
+        std::cout << "Copied shared graph " << fname << " in " << std::setprecision(3) << t.seconds() << "s" << std::endl;
+        return true;
+    }
+    wrap_mapped(f, h, "shared graph", g, vweights, uniform_ew);
+    std::cout << "Attached shared graph " << fname << " (" << f.size << " bytes) in " << std::setprecision(3) << t.seconds() << "s" << std::endl;
+    return true;
+}
+
+//writes a host array at the next aligned offset, returns the offset used
+template<class host_vt>
+static uint64_t write_array(FILE* fp, uint64_t& pos, host_vt data, bool& ok){
+    static const char zeros[binary_graph_align] = {};
+    uint64_t pad = (binary_graph_align - pos % binary_graph_align) % binary_graph_align;
+    ok = ok && (fwrite(zeros, 1, pad, fp) == pad);
+    uint64_t offset = pos + pad;
+    size_t count = data.extent(0);
+    ok = ok && (count == 0 || fwrite(data.data(), sizeof(typename host_vt::value_type), count, fp) == count);
+    pos = offset + count * sizeof(typename host_vt::value_type);
+    return offset;
+}
+
+//writes a graph in the binary format using the widths of this matrix type
+//vertex weights are only stored if vweights is non-empty
+static bool write_graph(const char* fname, const matrix_t g, const wgt_vt vweights, bool uniform_ew){
+    FILE* fp = fopen(fname, "wb");
+    if(fp == nullptr){
+        std::cerr << "FATAL ERROR: Could not open " << fname << " for writing" << std::endl;
+        return false;
+    }
+    return write_stream(fp, fname, g, vweights, uniform_ew);
+}
+
+//writes a graph in the binary format into a new POSIX shared memory object named shm:<name>
+//the object stays until it is removed with unpublish_graph, even after this process exits
+//unit edge weights are stored too, so that attaching processes need not allocate them
+static bool publish_graph(const char* fname, const matrix_t g, const wgt_vt vweights, bool uniform_ew){
+    std::string name = shared_object_name(fname);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if(fd < 0){
+        std::cerr << "FATAL ERROR: Could not create shared graph " << fname << " (it may already exist)" << std::endl;
+        return false;
+    }
+    FILE* fp = fdopen(fd, "wb");
+    if(fp == nullptr){
+        ::close(fd);
+        shm_unlink(name.c_str());
+        std::cerr << "FATAL ERROR: Could not open " << fname << " for writing" << std::endl;
+        return false;
+    }
+    bool ok = write_stream(fp, fname, g, vweights, uniform_ew, true);
+    if(!ok) shm_unlink(name.c_str());
+    return ok;
+}
+
+static bool unpublish_graph(const char* fname){
+    if(shm_unlink(shared_object_name(fname).c_str()) != 0){
+        std::cerr << "FATAL ERROR: Could not remove shared graph " << fname << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//writes a binary graph to fp and closes it
+//the magic bytes are written last, so readers never accept a partially written graph
+//with store_unit_ew, the values array is written even if every edge weight is 1
+static bool write_stream(FILE* fp, const char* fname, const matrix_t g, const wgt_vt vweights, bool uniform_ew, bool store_unit_ew = false){
+    binary_graph_header h;
+    memset(&h, 0, sizeof(binary_graph_header));
+    memcpy(h.magic, binary_graph_magic, 8);
+    h.version = binary_graph_version;
+    h.ordinal_width = sizeof(ordinal_t);
+    h.offset_width = sizeof(edge_offset_t);
+    h.value_width = sizeof(scalar_t);
+    h.n = g.numRows();
+    h.nnz = g.nnz();
+    if(uniform_ew) h.flags |= binary_graph_uniform_ew;
+    if(uniform_ew && store_unit_ew) h.flags |= binary_graph_unit_ew_stored;
+    if(vweights.extent(0) > 0) h.flags |= binary_graph_has_vwgt;
+    //header is rewritten with the magic bytes once the array offsets are known
+    binary_graph_header pending = h;
+    memset(pending.magic, 0, 8);
+    bool ok = (fwrite(&pending, sizeof(binary_graph_header), 1, fp) == 1);
+    uint64_t pos = sizeof(binary_graph_header);
+    auto row_map = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), g.graph.row_map);
+    h.row_map_offset = write_array(fp, pos, row_map, ok);
+    auto entries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), g.graph.entries);
+    h.entries_offset = write_array(fp, pos, entries, ok);
+    if(!uniform_ew || store_unit_ew){
+        auto values = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), g.values);
+        h.values_offset = write_array(fp, pos, values, ok);
+    }
+    if(h.flags & binary_graph_has_vwgt){
+        auto vwgt = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), vweights);
+        h.vwgt_offset = write_array(fp, pos, vwgt, ok);
+    }
+    ok = ok && (fseek(fp, 0, SEEK_SET) == 0);
+    ok = ok && (fwrite(&h, sizeof(binary_graph_header), 1, fp) == 1);
+    ok = (fclose(fp) == 0) && ok;
+    if(!ok){
+        std::cerr << "FATAL ERROR: Failed to write binary graph to " << fname << std::endl;
+    }
+    return ok;
+}
+};
+
+}
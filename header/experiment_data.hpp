@@ -131,6 +131,7 @@ private:
     scalar_t largest_part = 0;
     scalar_t smallest_part = 0;
     int64_t obj = 0;
+    bool truncated = false;
 
 public:
 	experiment_data() :
@@ -158,6 +159,15 @@ public:
         this->obj = x;
     }
 
+    //set when refinement was cut short by a deadline or cancellation
+    void setTruncated(bool x){
+        this->truncated = x;
+    }
+
+    bool isTruncated() const {
+        return truncated;
+    }
+
     void setLargestPartSize(scalar_t x){
         this->largest_part = x;
     }
@@ -174,7 +184,23 @@ public:
 		return measurements[static_cast<int>(m)];
 	}
 
-	void log(char* filename, bool first, bool last) {
+    //writes the metrics as one json object
+    void writeJson(std::ostream& f) {
+        f << "{";
+        f << "\"edge-cut\":" << std::fixed << fine_ec << ",";
+        f << "\"max-part-cut\":" << max_part_cut << ",";
+        f << "\"objective\":" << obj << ",";
+        f << "\"imbalance-ratio\":" << imb_ratio << ',';
+        f << "\"truncated\":" << (truncated ? "true" : "false") << ',';
+        for (int i = 0; i < static_cast<int>(Measurement::END); i++) {
+            f << "\"" << measurementNames[i] << "-duration-seconds\":" << measurements[i] << ",";
+        }
+        f << "\"number-coarse-levels\":" << numCoarseLevels << ",";
+        f << "\"finest-refinement-duration-seconds\":" << coarseLevels.back().totalRefTime;
+        f << "}";
+    }
+
+	void log(const char* filename, bool first, bool last) {
 		std::ofstream f;
 		f.open(filename, std::ios::app);
 
@@ -182,17 +208,7 @@ public:
 			if (first) {
 				f << "[";
 			}
-			f << "{";
-            f << "\"edge-cut\":" << std::fixed << fine_ec << ",";
-            f << "\"max-part-cut\":" << max_part_cut << ",";
-            f << "\"objective\":" << obj << ",";
-			f << "\"imbalance-ratio\":" << imb_ratio << ',';
-			for (int i = 0; i < static_cast<int>(Measurement::END); i++) {
-				f << "\"" << measurementNames[i] << "-duration-seconds\":" << measurements[i] << ",";
-			}
-			f << "\"number-coarse-levels\":" << numCoarseLevels << ",";
-            f << "\"finest-refinement-duration-seconds\":" << coarseLevels.back().totalRefTime;
-			f << "}";
+			writeJson(f);
 			if (!last) {
 				f << ",";
 			}
@@ -211,6 +227,7 @@ public:
         std::cout << "; Max part cut: " << std::fixed << max_part_cut;
         std::cout << "; imb: " << imb_ratio;
         std::cout << "; largest: " << largest_part << "; smallest: " << smallest_part << std::endl;
+        if(truncated) std::cout << "Refinement was truncated by the deadline or cancellation" << std::endl;
         std::cout << std::setprecision(5);
         std::cout << "Coarsening time: " << getMeasurement(Measurement::Coarsen) << std::endl;
         std::cout << " - Coarsening aggregation time: " << getMeasurement(Measurement::Map) << std::endl;
@@ -237,7 +254,7 @@ public:
             int level = coarseLevels.size() - 1 - i;
             std::cout << std::fixed << std::left << std::setw(6) << level << std::setw(16) << cl.edge_cut << std::setw(10) << cl.imb;
             std::cout << std::setw(13) << cl.numVertices << std::setw(16) << cl.numEdges << std::setw(22) << cl.totalRefTime;
-            std::cout << std::setw(17) << cl.totalIterations << std::setw(14) << cl.lpIterations << std::setw(23) << (cl.iterationsTime / cl.totalIterations) << std::endl;
+            std::cout << std::setw(17) << cl.totalIterations << std::setw(14) << cl.lpIterations << std::setw(23) << (cl.totalIterations > 0 ? cl.iterationsTime / cl.totalIterations : 0.0) << std::endl;
         }
     }
 };
@@ -36,74 +36,562 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 // ************************************************************************
-
+#pragma once
 #include "jet_defs.h"
 #include "experiment_data.hpp"
 #include "jet_config.h"
+#include <future>
+#include <memory>
+#include <vector>
 
 namespace jet_partitioner {
 
+//keeps the partitioner's scratch memory and random pool between calls
+//repeated calls on similar graphs that share a context do not reallocate scratch memory
+//a context may only be used by one call at a time and must be destroyed before Kokkos::finalize
+class context {
+public:
+    context();
+    ~context();
+    context(const context&) = delete;
+    context& operator=(const context&) = delete;
+
+    struct impl;
+    std::unique_ptr<impl> data;
+};
+
+//every kernel is launched on exec, so calls on separate instances of an execution space
+//(see Kokkos::Experimental::partition_space) can run concurrently from different threads
 part_vt partition(value_t& edge_cut,
                 const config_t& config,
                 const matrix_t g,
                 const wgt_vt vweights,
                 bool uniform_ew,
-                experiment_data<value_t>& experiment);
+                experiment_data<value_t>& experiment,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
 
 part_mt partition_host(value_t& edge_cut,
                 const config_t& config,
                 const host_matrix_t g,
                 const wgt_host_vt vweights,
                 bool uniform_ew,
-                experiment_data<value_t>& experiment);
+                experiment_data<value_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
 
 part_mt partition_serial(value_t& edge_cut,
                 const config_t& config,
                 const serial_matrix_t g,
                 const wgt_serial_vt vweights,
                 bool uniform_ew,
-                experiment_data<value_t>& experiment);
+                experiment_data<value_t>& experiment,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+//partitions each graph of a batch independently with the same config, for workloads of many small graphs
+//the execution space is split into instances (0 picks a default) that each work through the batch on their own thread
+//edge_cuts receives one cut per graph and seconds the wall time of the batch, so the throughput is graphs.size() / seconds
+std::vector<part_vt> partition_batch(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<matrix_t>& graphs,
+                const std::vector<wgt_vt>& vweights,
+                const std::vector<bool>& uniform_ew,
+                int instances,
+                double& seconds);
+
+std::vector<part_mt> partition_host_batch(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<host_matrix_t>& graphs,
+                const std::vector<wgt_host_vt>& vweights,
+                const std::vector<bool>& uniform_ew,
+                int instances,
+                double& seconds);
+
+std::vector<part_mt> partition_serial_batch(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<serial_matrix_t>& graphs,
+                const std::vector<wgt_serial_vt>& vweights,
+                const std::vector<bool>& uniform_ew,
+                int instances,
+                double& seconds);
 
 part_vt partition_big(big_val_t& edge_cut,
                 const config_t& config,
                 const big_matrix_t g,
                 const big_wgt_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment);
+                experiment_data<big_val_t>& experiment,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
 
 part_mt partition_host_big(big_val_t& edge_cut,
                 const config_t& config,
                 const big_host_matrix_t g,
                 const big_wgt_host_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment);
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
 
 part_mt partition_serial_big(big_val_t& edge_cut,
                 const config_t& config,
                 const big_serial_matrix_t g,
                 const big_wgt_serial_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment);
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
 
 part_vt partition_biggest(big_val_t& edge_cut,
                 const config_t& config,
                 const biggest_matrix_t g,
                 const big_wgt_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment);
+                experiment_data<big_val_t>& experiment,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
 
 part_mt partition_host_biggest(big_val_t& edge_cut,
                 const config_t& config,
                 const biggest_host_matrix_t g,
                 const big_wgt_host_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment);
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
 
 part_mt partition_serial_biggest(big_val_t& edge_cut,
                 const config_t& config,
                 const biggest_serial_matrix_t g,
                 const big_wgt_serial_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment);
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+//partitions g once for every entry of part_counts (config.num_parts is ignored), coarsening only once
+//the hierarchy is coarsened to the cutoff of the part count that needs the smallest coarsest graph,
+//and the other part counts start refinement from the level at which their own coarsening would have stopped
+//edge_cuts and experiments receive one entry per part count
+std::vector<part_vt> partition_sweep(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const matrix_t g,
+                const wgt_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<value_t>>& experiments,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+std::vector<part_mt> partition_host_sweep(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const host_matrix_t g,
+                const wgt_host_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<value_t>>& experiments,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+std::vector<part_mt> partition_serial_sweep(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const serial_matrix_t g,
+                const wgt_serial_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<value_t>>& experiments,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+std::vector<part_vt> partition_big_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const big_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+std::vector<part_mt> partition_host_big_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const big_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+std::vector<part_mt> partition_serial_big_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const big_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+std::vector<part_vt> partition_biggest_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const biggest_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+std::vector<part_mt> partition_host_biggest_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const biggest_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+std::vector<part_mt> partition_serial_biggest_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const biggest_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+//warm start: refines an existing partition in place and returns it, skipping coarsening and initial partitioning
+//part must hold a part id in [0, config.num_parts) for every vertex
+//suited to repartitioning after small changes to a graph that was already partitioned
+part_vt refine(value_t& edge_cut,
+                const config_t& config,
+                const matrix_t g,
+                const wgt_vt vweights,
+                bool uniform_ew,
+                part_vt part,
+                experiment_data<value_t>& experiment,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+part_mt refine_host(value_t& edge_cut,
+                const config_t& config,
+                const host_matrix_t g,
+                const wgt_host_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<value_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+part_mt refine_serial(value_t& edge_cut,
+                const config_t& config,
+                const serial_matrix_t g,
+                const wgt_serial_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<value_t>& experiment,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+part_vt refine_big(big_val_t& edge_cut,
+                const config_t& config,
+                const big_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                part_vt part,
+                experiment_data<big_val_t>& experiment,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+part_mt refine_host_big(big_val_t& edge_cut,
+                const config_t& config,
+                const big_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+part_mt refine_serial_big(big_val_t& edge_cut,
+                const config_t& config,
+                const big_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+part_vt refine_biggest(big_val_t& edge_cut,
+                const config_t& config,
+                const biggest_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                part_vt part,
+                experiment_data<big_val_t>& experiment,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+part_mt refine_host_biggest(big_val_t& edge_cut,
+                const config_t& config,
+                const biggest_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+part_mt refine_serial_biggest(big_val_t& edge_cut,
+                const config_t& config,
+                const biggest_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+//the outcome of an asynchronous partitioning call
+template<typename part_view_t, typename scalar_t>
+struct partition_result {
+    part_view_t part;
+    scalar_t edge_cut = 0;
+    experiment_data<scalar_t> experiment;
+};
+
+//starts partitioning on exec and returns at once, the partition is ready when the future is
+//use a separate execution space instance for other kernels that run meanwhile
+//g, vweights and ctx must not be modified or destroyed before the future is ready
+std::future<partition_result<part_vt, value_t>> partition_async(const config_t& config,
+                const matrix_t g,
+                const wgt_vt vweights,
+                bool uniform_ew,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+std::future<partition_result<part_mt, value_t>> partition_host_async(const config_t& config,
+                const host_matrix_t g,
+                const wgt_host_vt vweights,
+                bool uniform_ew,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+std::future<partition_result<part_mt, value_t>> partition_serial_async(const config_t& config,
+                const serial_matrix_t g,
+                const wgt_serial_vt vweights,
+                bool uniform_ew,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+std::future<partition_result<part_vt, big_val_t>> partition_big_async(const config_t& config,
+                const big_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+std::future<partition_result<part_mt, big_val_t>> partition_host_big_async(const config_t& config,
+                const big_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+std::future<partition_result<part_mt, big_val_t>> partition_serial_big_async(const config_t& config,
+                const big_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+std::future<partition_result<part_vt, big_val_t>> partition_biggest_async(const config_t& config,
+                const biggest_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+std::future<partition_result<part_mt, big_val_t>> partition_host_biggest_async(const config_t& config,
+                const biggest_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+std::future<partition_result<part_mt, big_val_t>> partition_serial_biggest_async(const config_t& config,
+                const biggest_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+//zero-copy variants that partition a graph held in caller-owned CSR arrays and write the partition to part
+//xadj has n + 1 offsets, the arrays must be accessible from exec and are neither copied nor modified
+//the partition is refined directly in part at the finest level, so it is not copied either
+//adjwgt and vwgt may be null for unit weights, in which case those weights are allocated
+//a null adjwgt allocates an nnz-sized array of ones, so for graphs near the memory limit pass unit weights in adjwgt
+//overloads cover the index and weight widths of the standard, big and biggest graph types
+void partition_csr(value_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const edge_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const value_t* adjwgt,
+                const value_t* vwgt,
+                part_t* part,
+                experiment_data<value_t>& experiment,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+void partition_host_csr(value_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const edge_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const value_t* adjwgt,
+                const value_t* vwgt,
+                part_t* part,
+                experiment_data<value_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+void partition_serial_csr(value_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const edge_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const value_t* adjwgt,
+                const value_t* vwgt,
+                part_t* part,
+                experiment_data<value_t>& experiment,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+void partition_csr(big_val_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const big_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+void partition_host_csr(big_val_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const big_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+void partition_serial_csr(big_val_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const big_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+void partition_csr(big_val_t& edge_cut,
+                const config_t& config,
+                big_ordinal_t n,
+                const big_offset_t* xadj,
+                const big_ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Device& exec = Device(),
+                context* ctx = nullptr);
+
+void partition_host_csr(big_val_t& edge_cut,
+                const config_t& config,
+                big_ordinal_t n,
+                const big_offset_t* xadj,
+                const big_ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec = Kokkos::DefaultHostExecutionSpace(),
+                context* ctx = nullptr);
+
+void partition_serial_csr(big_val_t& edge_cut,
+                const config_t& config,
+                big_ordinal_t n,
+                const big_offset_t* xadj,
+                const big_ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec = Kokkos::Serial(),
+                context* ctx = nullptr);
+
+//a graph and its partition held by the library and updated by batches of changes
+//after each batch only the region around the changed vertices is refined
+//a dynamic graph must be destroyed before Kokkos::finalize
+class dynamic_graph {
+public:
+    dynamic_graph();
+    ~dynamic_graph();
+    dynamic_graph(const dynamic_graph&) = delete;
+    dynamic_graph& operator=(const dynamic_graph&) = delete;
+
+    struct impl;
+    std::unique_ptr<impl> data;
+};
+
+//a batch of changes to a dynamic graph, any of the lists may be empty
+//each inserted or deleted edge is given once and applies to both directions
+//inserting an existing edge adds to its weight
+//new vertices get the ids following the current vertices, have weight 1 and may appear in the same batch
+struct graph_update {
+    vtx_vt insert_src, insert_dst;
+    wgt_vt insert_wgt;
+    vtx_vt delete_src, delete_dst;
+    vtx_vt weight_vertices;
+    wgt_vt weight_values;
+    ordinal_t new_vertices = 0;
+};
+
+//copies g, its vertex weights and a partition of it into dg
+//part must hold a part id in [0, config.num_parts) for every vertex
+void init_dynamic(dynamic_graph& dg,
+                const config_t& config,
+                const matrix_t g,
+                const wgt_vt vweights,
+                const part_vt part,
+                const Device& exec = Device());
+
+//applies a batch of changes and refines the partition around them, returns the new edge cut
+value_t update_dynamic(dynamic_graph& dg, const graph_update& update);
+
+//the current partition, valid until the next update
+part_vt dynamic_partition(const dynamic_graph& dg);
+
+//a compact copy of the current graph
+matrix_t dynamic_matrix(const dynamic_graph& dg);
+
+//recomputes the edge cut and part sizes of dg from scratch and compares them with the maintained values
+//prints each difference to stderr and returns false if there is any
+bool verify_dynamic(const dynamic_graph& dg);
 
 }
\ No newline at end of file
@@ -0,0 +1,120 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#pragma once
+#include <stdint.h>
+
+//C interface to the partitioner for embedding in C and Fortran codes
+//graphs are passed as host CSR arrays in the METIS layout, each edge appears in both directions
+//functions return JET_OK on success and an error code otherwise
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define JET_OK 0
+#define JET_ERROR_NOT_INITIALIZED 1
+#define JET_ERROR_INVALID_ARGUMENT 2
+#define JET_ERROR_INTERNAL 3
+
+//keeps scratch memory between partition calls, see jet_partitioner::context
+typedef struct jet_context_s* jet_context;
+
+//options must be filled by jet_options_init, which sets struct_size
+//fields are only ever appended, and fields past the struct_size a caller was built with keep their defaults,
+//so binaries built against an older jet_c.h keep working
+typedef struct jet_options {
+    uint64_t struct_size;
+    int32_t num_parts;
+    double max_imb_ratio;
+    int32_t coarsening_alg;
+    double refine_tolerance;
+    //0 uses the current time
+    uint64_t seed;
+    int32_t ultra_settings;
+    int32_t verbose;
+    //seconds after which refinement only rebalances and returns, 0 for no limit
+    //this sets config_t::deadline relative to the start of the call
+    double time_limit;
+    //tuning parameters, see config_t for their meaning and limits
+    int32_t coarse_vertices_per_part;
+    //0 uses coarse_vertices_per_part
+    int32_t coarse_cutoff;
+    uint32_t max_levels;
+    double lp_temp_uniform;
+    double lp_temp_weighted;
+    double ultra_temp_start;
+    double ultra_temp_step;
+    int32_t refine_patience;
+    int32_t max_buckets;
+    int32_t max_sections;
+    double update_large_ratio;
+} jet_options;
+
+//initializes Kokkos unless the application already did
+//num_threads and device_id are passed to Kokkos when positive or zero respectively, -1 keeps the defaults
+int jet_initialize(int32_t num_threads, int32_t device_id);
+
+//finalizes Kokkos only if jet_initialize initialized it, all contexts must be destroyed first
+int jet_finalize(void);
+
+//sets options->struct_size and fills every field with the defaults of config_t
+void jet_options_init(jet_options* options);
+
+int jet_context_create(jet_context* ctx);
+void jet_context_destroy(jet_context ctx);
+
+//partitions a graph with n vertices into part, which must hold n entries
+//options outside the limits documented in config_t are rejected with JET_ERROR_INVALID_ARGUMENT
+//adjwgt and vwgt may be null for unit weights, ctx may be null, truncated may be null
+//a null adjwgt allocates an nnz-sized array of ones, so for graphs near the memory limit pass unit weights in adjwgt
+//edge_cut receives the edge cut and truncated is set to 1 if the time limit cut refinement short
+int jet_partition(const jet_options* options, int32_t n, const int32_t* xadj, const int32_t* adjncy,
+    const int32_t* adjwgt, const int32_t* vwgt, int32_t* part, int32_t* edge_cut, int32_t* truncated, jet_context ctx);
+
+//for graphs with more than 2^31 edges or 64-bit weights
+int jet_partition_big(const jet_options* options, int32_t n, const int64_t* xadj, const int32_t* adjncy,
+    const int64_t* adjwgt, const int64_t* vwgt, int32_t* part, int64_t* edge_cut, int32_t* truncated, jet_context ctx);
+
+//for graphs with more than 2^31 vertices
+int jet_partition_biggest(const jet_options* options, int64_t n, const int64_t* xadj, const int64_t* adjncy,
+    const int64_t* adjwgt, const int64_t* vwgt, int32_t* part, int64_t* edge_cut, int32_t* truncated, jet_context ctx);
+
+#ifdef __cplusplus
+}
+#endif
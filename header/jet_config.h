@@ -37,6 +37,8 @@
 //
 // ************************************************************************
 #pragma once
+#include <atomic>
+#include <chrono>
 
 namespace jet_partitioner {
 
@@ -47,8 +49,42 @@ struct config_t {
     int num_parts = 2;
     double refine_tolerance = 0.999;
     bool dump_coarse = false;
+    //destination of the coarse hierarchy when dump_coarse is set
+    const char* coarse_dump_file = "coarse_graphs.out";
+    //seed for the coarsening heuristics, 0 uses the current time
+    unsigned long long seed = 0;
+    //directory for cached coarse hierarchies, caching is disabled if null or if seed is 0
+    //a hierarchy is reused for any later run with the same graph, heuristic, seed and coarsening cutoff
+    const char* hierarchy_cache_dir = nullptr;
     bool verbose = false;
     bool ultra_settings = false;
+    //coarsening stops at coarse_vertices_per_part*k vertices, or at a quarter of that (but at least 1024) when it exceeds 1024
+    //a positive coarse_cutoff replaces this rule
+    int coarse_vertices_per_part = 8;
+    int coarse_cutoff = 0;
+    unsigned int max_levels = 200;
+    //label propagation temperatures, the fraction of vertices with positive gain that may move
+    //ultra settings go from ultra_temp_start down to 0 in steps of ultra_temp_step
+    double lp_temp_uniform = 0.25;
+    double lp_temp_weighted = 0.75;
+    double ultra_temp_start = 0.85;
+    double ultra_temp_step = 0.05;
+    //refinement iterations without significant improvement before a temperature ends
+    int refine_patience = 12;
+    //gain buckets (between 4 and 64) and per-part sections (between 1 and 4096) of the rebalancing minibuckets
+    int max_buckets = 50;
+    int max_sections = 128;
+    //connectivity is rebuilt instead of updated once more than this fraction of vertices moves in an iteration
+    double update_large_ratio = 0.1;
+    //refinement stops early once this time passes or cancel is set (cancel may be set from another thread)
+    //the remaining levels are only projected and rebalanced, and the experiment data is marked as truncated
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    const std::atomic<bool>* cancel = nullptr;
+
+    bool expired() const {
+        if(cancel != nullptr && cancel->load(std::memory_order_relaxed)) return true;
+        return deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline;
+    }
 };
 
 }
\ No newline at end of file
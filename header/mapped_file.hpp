@@ -0,0 +1,135 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace jet_partitioner {
+
+//read-only memory mapping of an entire file
+//used by the graph loaders to avoid copying file contents into a separate buffer
+//a copy-on-write mapping may be modified in memory without changing the file
+class mapped_file {
+public:
+    const char* data = nullptr;
+    size_t size = 0;
+    bool copy_on_write = false;
+
+    mapped_file() {}
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file(){
+        close();
+    }
+
+bool open(const char* fname, bool _copy_on_write = false){
+    close();
+    int fd = ::open(fname, O_RDONLY);
+    if(fd < 0) return false;
+    return map(fd, _copy_on_write);
+}
+
+//maps a POSIX shared memory object read-only, name is as given to shm_open
+bool open_shared(const char* name){
+    close();
+    int fd = shm_open(name, O_RDONLY, 0);
+    if(fd < 0) return false;
+    return map(fd, false);
+}
+
+//maps all of fd and closes it
+bool map(int fd, bool _copy_on_write){
+    struct stat st;
+    //only regular files can be mapped
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)){
+        ::close(fd);
+        return false;
+    }
+    size_t sz = st.st_size;
+    if(sz > 0){
+        int prot = _copy_on_write ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        void* p = mmap(nullptr, sz, prot, MAP_PRIVATE, fd, 0);
+        if(p == MAP_FAILED){
+            ::close(fd);
+            return false;
+        }
+        data = static_cast<const char*>(p);
+    }
+    size = sz;
+    copy_on_write = _copy_on_write;
+    //the mapping remains valid after the descriptor is closed
+    ::close(fd);
+    return true;
+}
+
+//hint that the file will be read front to back so the kernel reads ahead aggressively
+void advise_sequential(){
+    if(data != nullptr) posix_madvise(const_cast<char*>(data), size, POSIX_MADV_SEQUENTIAL);
+}
+
+//only valid for copy-on-write mappings
+char* writable_data() const {
+    return copy_on_write ? const_cast<char*>(data) : nullptr;
+}
+
+//drops resident pages that lie entirely within [begin, end)
+//the pages are re-read from the file if accessed again
+//does nothing for copy-on-write mappings, whose modified pages would be lost
+void release(const char* begin, const char* end){
+    if(data == nullptr || copy_on_write) return;
+    uintptr_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t b = (reinterpret_cast<uintptr_t>(begin) + page - 1) / page * page;
+    uintptr_t e = reinterpret_cast<uintptr_t>(end) / page * page;
+    if(e > b) madvise(reinterpret_cast<void*>(b), e - b, MADV_DONTNEED);
+}
+
+void close(){
+    if(data != nullptr) munmap(const_cast<char*>(data), size);
+    data = nullptr;
+    size = 0;
+    copy_on_write = false;
+}
+};
+
+}
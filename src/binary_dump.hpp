@@ -36,13 +36,62 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 // ************************************************************************
+#pragma once
 #include "contract.hpp"
+#include "binary_graph.hpp"
+#include "mapped_file.hpp"
 #include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <list>
+#include <algorithm>
 #include <Kokkos_Core.hpp>
 #include "KokkosSparse_CrsMatrix.hpp"
 
 namespace jet_partitioner {
 
+//on-disk layout of a coarse graph hierarchy
+//the header is followed by one hierarchy_level per level, finest level first
+//every array begins at an offset that is a multiple of binary_graph_align
+//type widths are in bytes and may be 4 or 8 (signed integers)
+struct hierarchy_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t levels;
+    uint32_t ordinal_width;
+    uint32_t offset_width;
+    uint32_t value_width;
+    uint32_t part_width;
+    uint32_t flags;
+    uint32_t reserved;
+    //partition of the coarsest level, part_n is 0 if it is absent
+    uint64_t part_offset;
+    uint64_t part_n;
+};
+static_assert(sizeof(hierarchy_header) == 56, "hierarchy header must be 56 bytes");
+
+struct hierarchy_level {
+    uint64_t n;
+    uint64_t nnz;
+    uint64_t row_map_offset;
+    uint64_t entries_offset;
+    uint64_t values_offset;
+    uint64_t vwgt_offset;
+    //maps each vertex of the previous (finer) level to this level, unused for the finest level
+    uint64_t map_offset;
+    //sum of the checksums of every array in this level
+    uint64_t checksum;
+    uint32_t uniform_weights;
+    uint32_t reserved;
+};
+static_assert(sizeof(hierarchy_level) == 72, "hierarchy level must be 72 bytes");
+
+inline constexpr char hierarchy_magic[8] = {'J', 'E', 'T', 'H', 'I', 'E', 'R', '\0'};
+inline constexpr uint32_t hierarchy_version = 1;
+//the arrays of the finest level are not stored, the reader must supply that level
+inline constexpr uint32_t hierarchy_omit_finest = 1;
+
 template<class crsMat, typename part_t>
 class binary_dump {
 public:
@@ -52,48 +101,219 @@ public:
     using ordinal_t = typename matrix_t::ordinal_type;
     using edge_offset_t = typename matrix_t::size_type;
     using scalar_t = typename matrix_t::value_type;
+    using vtx_vt = Kokkos::View<ordinal_t*, Device>;
+    using edge_vt = Kokkos::View<edge_offset_t*, Device>;
+    using wgt_vt = Kokkos::View<scalar_t*, Device>;
     using part_vt = Kokkos::View<part_t*, Device>;
+    using graph_t = typename matrix_t::staticcrsgraph_type;
     using coarsener_t = contracter<matrix_t>;
     using clt = typename coarsener_t::coarse_level_triple;
+    using bg = binary_graph<matrix_t>;
+    using host_policy = Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>;
+    static constexpr bool is_host_space = std::is_same<typename Device::memory_space, Kokkos::HostSpace>::value;
+
+//order-sensitive checksum of a byte array
+//each 8 byte word is mixed with its index so the words can be summed in parallel
+static uint64_t checksum(const char* data, size_t bytes){
+    size_t words = (bytes + 7) / 8;
+    uint64_t sum = 0;
+    Kokkos::parallel_reduce("hierarchy checksum", host_policy(0, words), [=](const size_t i, uint64_t& update){
+        uint64_t w = 0;
+        memcpy(&w, data + 8*i, std::min<size_t>(8, bytes - 8*i));
+        //splitmix64 finalizer
+        uint64_t z = w + (i + 1) * 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        update += z ^ (z >> 31);
+    }, sum);
+    return sum;
+}
+
+//copies a device array to the host, writes it at the next aligned offset and adds its checksum to sum
+template<class view_t>
+static uint64_t write_view(FILE* fp, uint64_t& pos, view_t data, uint64_t& sum, bool& ok){
+    auto data_m = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), data);
+    sum += checksum(reinterpret_cast<const char*>(data_m.data()), data_m.extent(0) * sizeof(typename view_t::value_type));
+    return bg::write_array(fp, pos, data_m, ok);
+}
 
-//writes a sequence of coarse graphs and mappings between each graph to binary file
+//writes a sequence of coarse graphs, the mappings between each graph,
+//and a partition of the coarsest graph to a binary file
 //used to control for coarsening when experimenting with refinement
-static void dump_coarse(std::list<clt> levels){
-    FILE* cgfp = fopen("coarse_graphs.out", "w");
-    int size = levels.size();
-    fwrite(&size, sizeof(int), 1, cgfp);
-    ordinal_t prev_n = 0;
-    for(auto level : levels){
-        matrix_t g = level.mtx;
-        ordinal_t N = g.numRows();
-        edge_offset_t M = g.nnz();
-        auto rows = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), g.graph.row_map);
-        auto entries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), g.graph.entries);
-        auto values = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), g.values);
-        auto vtx_wgts = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), level.vtx_w);
-        fwrite(&N, sizeof(ordinal_t), 1, cgfp);
-        fwrite(&M, sizeof(edge_offset_t), 1, cgfp);
-        fwrite(rows.data(), sizeof(edge_offset_t), N+1, cgfp);
-        fwrite(entries.data(), sizeof(ordinal_t), M, cgfp);
-        fwrite(values.data(), sizeof(scalar_t), M, cgfp);
-        fwrite(vtx_wgts.data(), sizeof(scalar_t), N, cgfp);
-        if(level.level > 1){
-            typename jet_partitioner::contracter<matrix_t>::coarse_map interp_mtx = level.interp_mtx;
-            auto i_entries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), interp_mtx.map);
-            fwrite(i_entries.data(), sizeof(ordinal_t), prev_n, cgfp);
+//part may be empty, and the finest graph may be omitted if the reader already has it
+static bool dump_coarse(const char* fname, const std::list<clt>& levels, part_vt part, bool omit_finest = false){
+    FILE* fp = fopen(fname, "wb");
+    if(fp == nullptr){
+        std::cerr << "FATAL ERROR: Could not open " << fname << " for writing" << std::endl;
+        return false;
+    }
+    hierarchy_header h;
+    memset(&h, 0, sizeof(hierarchy_header));
+    memcpy(h.magic, hierarchy_magic, 8);
+    h.version = hierarchy_version;
+    h.levels = levels.size();
+    h.ordinal_width = sizeof(ordinal_t);
+    h.offset_width = sizeof(edge_offset_t);
+    h.value_width = sizeof(scalar_t);
+    h.part_width = sizeof(part_t);
+    if(omit_finest) h.flags |= hierarchy_omit_finest;
+    std::vector<hierarchy_level> table(levels.size());
+    memset(table.data(), 0, table.size() * sizeof(hierarchy_level));
+    //header and level table are rewritten once the array offsets are known
+    bool ok = (fwrite(&h, sizeof(hierarchy_header), 1, fp) == 1);
+    ok = ok && (fwrite(table.data(), sizeof(hierarchy_level), table.size(), fp) == table.size());
+    uint64_t pos = sizeof(hierarchy_header) + table.size() * sizeof(hierarchy_level);
+    size_t i = 0;
+    for(const clt& level : levels){
+        hierarchy_level& l = table[i];
+        const matrix_t& g = level.mtx;
+        l.n = g.numRows();
+        l.nnz = g.nnz();
+        l.uniform_weights = level.uniform_weights;
+        if(i == 0 && omit_finest){
+            i++;
+            continue;
         }
-        prev_n = N;
+        l.row_map_offset = write_view(fp, pos, g.graph.row_map, l.checksum, ok);
+        l.entries_offset = write_view(fp, pos, g.graph.entries, l.checksum, ok);
+        l.values_offset = write_view(fp, pos, g.values, l.checksum, ok);
+        l.vwgt_offset = write_view(fp, pos, level.vtx_w, l.checksum, ok);
+        if(i > 0){
+            l.map_offset = write_view(fp, pos, level.interp_mtx.map, l.checksum, ok);
+        }
+        i++;
+    }
+    uint64_t part_sum = 0;
+    h.part_n = part.extent(0);
+    h.part_offset = write_view(fp, pos, part, part_sum, ok);
+    ok = ok && (fseek(fp, 0, SEEK_SET) == 0);
+    ok = ok && (fwrite(&h, sizeof(hierarchy_header), 1, fp) == 1);
+    ok = ok && (fwrite(table.data(), sizeof(hierarchy_level), table.size(), fp) == table.size());
+    ok = (fclose(fp) == 0) && ok;
+    if(!ok){
+        std::cerr << "FATAL ERROR: Failed to write coarse hierarchy to " << fname << std::endl;
+    }
+    return ok;
+}
+
+//reads and validates the header and level table of a mapped hierarchy file
+static bool read_header(const mapped_file& f, hierarchy_header& h, std::vector<hierarchy_level>& table){
+    if(f.size < sizeof(hierarchy_header)) return false;
+    memcpy(&h, f.data, sizeof(hierarchy_header));
+    if(memcmp(h.magic, hierarchy_magic, 8) != 0 || h.version != hierarchy_version) return false;
+    for(uint32_t w : {h.ordinal_width, h.offset_width, h.value_width, h.part_width}){
+        if(w != 4 && w != 8) return false;
+    }
+    if(h.levels == 0 || h.levels > (f.size - sizeof(hierarchy_header)) / sizeof(hierarchy_level)) return false;
+    table.resize(h.levels);
+    memcpy(table.data(), f.data + sizeof(hierarchy_header), h.levels * sizeof(hierarchy_level));
+    //every array must be aligned and lie within the file
+    auto in_file = [&](uint64_t offset, uint64_t count, uint32_t width){
+        return (offset % binary_graph_align == 0) && offset <= f.size && count <= (f.size - offset) / width;
+    };
+    uint64_t prev_n = 0;
+    for(uint32_t i = 0; i < h.levels; i++){
+        const hierarchy_level& l = table[i];
+        prev_n = l.n;
+        if(i == 0 && (h.flags & hierarchy_omit_finest)) continue;
+        bool valid = in_file(l.row_map_offset, l.n + 1, h.offset_width) && in_file(l.entries_offset, l.nnz, h.ordinal_width)
+            && in_file(l.values_offset, l.nnz, h.value_width) && in_file(l.vwgt_offset, l.n, h.value_width);
+        if(i > 0) valid = valid && in_file(l.map_offset, table[i - 1].n, h.ordinal_width);
+        if(!valid) return false;
     }
-    fclose(cgfp);
+    return (h.part_n == 0 || h.part_n == prev_n) && in_file(h.part_offset, h.part_n, h.part_width);
 }
 
-//writes part to binary file
-static void dump_coarse_part(part_vt part){
-    FILE* cgfp = fopen("coarse_part.out", "wb");
-    ordinal_t n = part.extent(0);
-    auto part_m = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), part);
-    fwrite(part_m.data(), sizeof(part_t), n, cgfp);
-    fclose(cgfp);
+//recomputes the checksum of level i from the mapping
+static uint64_t level_checksum(const mapped_file& f, const hierarchy_header& h, const std::vector<hierarchy_level>& table, uint32_t i){
+    const hierarchy_level& l = table[i];
+    uint64_t sum = checksum(f.data + l.row_map_offset, (l.n + 1) * h.offset_width);
+    sum += checksum(f.data + l.entries_offset, l.nnz * h.ordinal_width);
+    sum += checksum(f.data + l.values_offset, l.nnz * h.value_width);
+    sum += checksum(f.data + l.vwgt_offset, l.n * h.value_width);
+    if(i > 0) sum += checksum(f.data + l.map_offset, table[i - 1].n * h.ordinal_width);
+    return sum;
+}
+
+//creates a view of count integers of the given width stored at offset
+//if the device can use host memory and the widths match, the view aliases the mapping
+//otherwise the values are copied into a new device view
+template<typename T>
+static bool map_array(const mapped_file& f, uint64_t offset, uint32_t width, size_t count, Kokkos::View<T*, Device>& dst, const char* label){
+    if(is_host_space && width == sizeof(T) && f.copy_on_write){
+        dst = Kokkos::View<T*, Device>(reinterpret_cast<T*>(f.writable_data() + offset), count);
+        return true;
+    }
+    dst = Kokkos::View<T*, Device>(Kokkos::ViewAllocateWithoutInitializing(label), count);
+    return bg::template read_array<T>(f.data + offset, width, count, dst);
+}
+
+//loads a hierarchy written by dump_coarse
+//f must outlive the graphs in levels, which may alias it
+//part always receives its own copy of the coarsest partition, or is empty if the file has none
+//finest supplies the finest level if the file omits it
+static bool load_coarse(const char* fname, mapped_file& f, std::list<clt>& levels, part_vt& part, const clt* finest = nullptr){
+    if(!f.open(fname, true)){
+        std::cerr << "FATAL ERROR: Could not open coarse hierarchy file " << fname << std::endl;
+        return false;
+    }
+    hierarchy_header h;
+    std::vector<hierarchy_level> table;
+    if(!read_header(f, h, table)){
+        std::cerr << "FATAL ERROR: " << fname << " is not a valid coarse hierarchy file" << std::endl;
+        return false;
+    }
+    levels.clear();
+    for(uint32_t i = 0; i < h.levels; i++){
+        const hierarchy_level& l = table[i];
+        if(i == 0 && (h.flags & hierarchy_omit_finest)){
+            if(finest == nullptr || static_cast<uint64_t>(finest->mtx.numRows()) != l.n
+                || static_cast<uint64_t>(finest->mtx.nnz()) != l.nnz){
+                std::cerr << "FATAL ERROR: " << fname << " does not store its finest graph and no matching graph was given" << std::endl;
+                return false;
+            }
+            levels.push_back(*finest);
+            continue;
+        }
+        if(l.n > static_cast<uint64_t>(std::numeric_limits<ordinal_t>::max())
+            || l.nnz > static_cast<uint64_t>(std::numeric_limits<edge_offset_t>::max())){
+            std::cerr << "FATAL ERROR: Level " << i + 1 << " of " << fname << " is too large for the requested graph types" << std::endl;
+            return false;
+        }
+        if(level_checksum(f, h, table, i) != l.checksum){
+            std::cerr << "FATAL ERROR: Checksum mismatch in level " << i + 1 << " of " << fname << std::endl;
+            return false;
+        }
+        clt level;
+        level.level = i + 1;
+        level.uniform_weights = l.uniform_weights;
+        edge_vt rows;
+        vtx_vt entries;
+        wgt_vt values;
+        bool ok = map_array<edge_offset_t>(f, l.row_map_offset, h.offset_width, l.n + 1, rows, "rows");
+        ok = ok && map_array<ordinal_t>(f, l.entries_offset, h.ordinal_width, l.nnz, entries, "entries");
+        ok = ok && map_array<scalar_t>(f, l.values_offset, h.value_width, l.nnz, values, "values");
+        ok = ok && map_array<scalar_t>(f, l.vwgt_offset, h.value_width, l.n, level.vtx_w, "vtx wgts");
+        if(ok && i > 0){
+            level.interp_mtx.coarse_vtx = l.n;
+            ok = map_array<ordinal_t>(f, l.map_offset, h.ordinal_width, table[i - 1].n, level.interp_mtx.map, "interp map");
+        }
+        if(!ok){
+            std::cerr << "FATAL ERROR: Values in level " << i + 1 << " of " << fname << " do not fit in the requested graph types" << std::endl;
+            return false;
+        }
+        graph_t graph(entries, rows);
+        level.mtx = matrix_t("g", l.n, values, graph);
+        levels.push_back(level);
+    }
+    //refinement writes to the coarsest partition in place
+    //which may eventually be returned to the caller, so it never aliases the mapping
+    part = part_vt(Kokkos::ViewAllocateWithoutInitializing("part"), h.part_n);
+    if(!bg::template read_array<part_t>(f.data + h.part_offset, h.part_width, h.part_n, part)){
+        std::cerr << "FATAL ERROR: Partition in " << fname << " does not fit in the requested part type" << std::endl;
+        return false;
+    }
+    return true;
 }
 };
-}
\ No newline at end of file
+}
@@ -39,6 +39,7 @@
 #pragma once
 #include <list>
 #include <limits>
+#include <random>
 #include <Kokkos_Core.hpp>
 #include "KokkosSparse_CrsMatrix.hpp"
 #include "KokkosKernels_HashmapAccumulator.hpp"
@@ -106,11 +107,19 @@ public:
     ordinal_t coarse_vtx_cutoff = 1000;
     ordinal_t min_allowed_vtx = 250;
     unsigned int max_levels = 200;
+    //seed for the random pool used by the coarsening heuristics, 0 picks a random seed
+    uint64_t seed = 0;
+    //instance for all coarsening work, see set_exec_space
+    exec_space exec;
+    //kept between calls to generate_coarse_graphs so that a reused contracter does not reallocate them
+    scratch_mem scratch;
+    pool_t rand_pool;
+    bool has_pool = false;
     const ordinal_t large_row_threshold = 1000;
     
 bool has_large_row(const matrix_t g){
     ordinal_t max_row = 0;
-    Kokkos::parallel_reduce("find max row", policy_t(0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update){
+    Kokkos::parallel_reduce("find max row", policy_t(exec, 0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update){
         ordinal_t degree = g.graph.row_map(i+1) - g.graph.row_map(i);
         if(degree > update) update = degree;
     }, Kokkos::Max<ordinal_t, Kokkos::HostSpace>(max_row));
@@ -355,30 +364,30 @@ coarse_level_triple build_coarse_graph(const coarse_level_triple level,
 
     Kokkos::Timer timer;
     edge_vt hrow_map = Kokkos::subview(scratch.hrow_map, std::make_pair(static_cast<ordinal_t>(0), nc + 1));
-    Kokkos::deep_copy(exec_space(), hrow_map, 0);
+    Kokkos::deep_copy(exec, hrow_map, 0);
     wgt_vt f_vtx_w = level.vtx_w;
     wgt_vt c_vtx_w = wgt_vt("coarse vertex weights", nc);
     countingFunctor countF(g, vcmap.map, hrow_map, c_vtx_w, f_vtx_w);
-    Kokkos::parallel_for("count edges per coarse vertex (also compute coarse vertex weights)", policy_t(0, n), countF);
-    Kokkos::fence();
+    Kokkos::parallel_for("count edges per coarse vertex (also compute coarse vertex weights)", policy_t(exec, 0, n), countF);
+    exec.fence();
     experiment.addMeasurement(Measurement::Count, timer.seconds());
     timer.reset();
     edge_offset_t hash_size = 0;
     //exclusive prefix sum
-    Kokkos::parallel_scan("scan offsets", policy_t(0, nc + 1), KOKKOS_LAMBDA(const ordinal_t i, edge_offset_t& update, const bool final){
+    Kokkos::parallel_scan("scan offsets", policy_t(exec, 0, nc + 1), KOKKOS_LAMBDA(const ordinal_t i, edge_offset_t& update, const bool final){
         edge_offset_t val = hrow_map(i);
         if(final){
             hrow_map(i) = update;
         }
         update += val;
     }, hash_size);
-    Kokkos::fence();
+    exec.fence();
     experiment.addMeasurement(Measurement::Prefix, timer.seconds());
     timer.reset();
     vtx_vt htable = Kokkos::subview(scratch.htable, std::make_pair(static_cast<edge_offset_t>(0), hash_size));
-    Kokkos::deep_copy(exec_space(), htable, NULL_KEY);
+    Kokkos::deep_copy(exec, htable, NULL_KEY);
     wgt_vt hvals = Kokkos::subview(scratch.hvals, std::make_pair(static_cast<edge_offset_t>(0), hash_size));
-    Kokkos::deep_copy(exec_space(), hvals, 0);
+    Kokkos::deep_copy(exec, hvals, 0);
     // use thread teams on gpu when graph has decent average degree or very large max degree
     bool use_team = (!is_host_space && (hash_size / n >= 12 || has_large_row(g)));
     //insert each coarse vertex into a bucket determined by a hash
@@ -386,49 +395,49 @@ coarse_level_triple build_coarse_graph(const coarse_level_triple level,
     //combine weights using atomic addition
     combineAndDedupe cnd(g, vcmap.map, htable, hvals, hrow_map);
     if(use_team) {
-        Kokkos::parallel_for("deduplicate", team_policy_t(n, Kokkos::AUTO), cnd);
+        Kokkos::parallel_for("deduplicate", team_policy_t(exec, n, Kokkos::AUTO), cnd);
     } else {
-        bool use_dyn = should_use_dyn(n, g.graph.row_map, exec_space().concurrency());
+        bool use_dyn = should_use_dyn(n, g.graph.row_map, exec.concurrency());
         if(use_dyn){
-            Kokkos::parallel_for("deduplicate", dyn_policy_t(0, n), cnd);
+            Kokkos::parallel_for("deduplicate", dyn_policy_t(exec, 0, n), cnd);
         } else {
-            Kokkos::parallel_for("deduplicate", policy_t(0, n), cnd);
+            Kokkos::parallel_for("deduplicate", policy_t(exec, 0, n), cnd);
         }
     }
-    Kokkos::fence();
+    exec.fence();
     experiment.addMeasurement(Measurement::Dedupe, timer.seconds());
     timer.reset();
     edge_vt coarse_row_map_f("edges_per_source", nc + 1);
     countUnique cu(htable, hrow_map, coarse_row_map_f);
     if(use_team) {
-        Kokkos::parallel_for("count unique", team_policy_t(nc, Kokkos::AUTO), cu);
+        Kokkos::parallel_for("count unique", team_policy_t(exec, nc, Kokkos::AUTO), cu);
     } else {
-        Kokkos::parallel_for("count unique", policy_t(0, nc), cu);
+        Kokkos::parallel_for("count unique", policy_t(exec, 0, nc), cu);
     }
-    Kokkos::fence();
+    exec.fence();
     experiment.addMeasurement(Measurement::WriteGraph, timer.seconds());
     timer.reset();
-    Kokkos::parallel_scan("scan offsets", policy_t(0, nc + 1), KOKKOS_LAMBDA(const ordinal_t i, edge_offset_t& update, const bool final){
+    Kokkos::parallel_scan("scan offsets", policy_t(exec, 0, nc + 1), KOKKOS_LAMBDA(const ordinal_t i, edge_offset_t& update, const bool final){
         edge_offset_t val = coarse_row_map_f(i);
         if(final){
             coarse_row_map_f(i) = update;
         }
         update += val;
     }, hash_size);
-    Kokkos::fence();
+    exec.fence();
     experiment.addMeasurement(Measurement::Prefix, timer.seconds());
     timer.reset();
     vtx_vt entries_coarse(Kokkos::ViewAllocateWithoutInitializing("coarse entries"), hash_size);
     wgt_vt wgts_coarse(Kokkos::ViewAllocateWithoutInitializing("coarse weights"), hash_size);
     consolidateUnique consolidate(htable, entries_coarse, hvals, wgts_coarse, hrow_map, coarse_row_map_f);
     if(use_team) {
-        Kokkos::parallel_for("consolidate", team_policy_t(nc, Kokkos::AUTO).set_scratch_size(0, Kokkos::PerTeam(4*sizeof(ordinal_t))), consolidate);
+        Kokkos::parallel_for("consolidate", team_policy_t(exec, nc, Kokkos::AUTO).set_scratch_size(0, Kokkos::PerTeam(4*sizeof(ordinal_t))), consolidate);
     } else {
-        bool use_dyn = should_use_dyn(nc, hrow_map, exec_space().concurrency());
+        bool use_dyn = should_use_dyn(nc, hrow_map, exec.concurrency());
         if(use_dyn){
-            Kokkos::parallel_for("consolidate", dyn_policy_t(0, nc), consolidate);
+            Kokkos::parallel_for("consolidate", dyn_policy_t(exec, 0, nc), consolidate);
         } else {
-            Kokkos::parallel_for("consolidate", policy_t(0, nc), consolidate);
+            Kokkos::parallel_for("consolidate", policy_t(exec, 0, nc), consolidate);
         }
     }
     graph_type gc_graph(entries_coarse, coarse_row_map_f);
@@ -439,7 +448,7 @@ coarse_level_triple build_coarse_graph(const coarse_level_triple level,
     next_level.level = level.level + 1;
     next_level.interp_mtx = vcmap;
     next_level.uniform_weights = false;
-    Kokkos::fence();
+    exec.fence();
     experiment.addMeasurement(Measurement::WriteGraph, timer.seconds());
     timer.reset();
     return next_level;
@@ -486,11 +495,27 @@ coarse_map generate_coarse_mapping(const matrix_t g,
             interpolation_graph = mapper.coarsen_match(g, uniform_weights, rand_pool, choice);
             break;
     }
-    Kokkos::fence();
+    exec.fence();
     experiment.addMeasurement(Measurement::Map, timer.seconds());
     return interpolation_graph;
 }
 
+//grows the scratch used by build_coarse_graph to fit a graph with n vertices and nnz entries
+//buffers that are already large enough are kept
+void reserve_scratch(ordinal_t n, edge_offset_t nnz){
+    if(scratch.htable.extent(0) < static_cast<size_t>(nnz)){
+        //old buffers are released first to limit peak memory
+        scratch.htable = vtx_vt();
+        scratch.htable = vtx_vt(Kokkos::view_alloc(Kokkos::WithoutInitializing, "htable scratch"), nnz);
+        scratch.hvals = wgt_vt();
+        scratch.hvals = wgt_vt(Kokkos::view_alloc(Kokkos::WithoutInitializing, "hvals scratch"), nnz);
+    }
+    if(scratch.hrow_map.extent(0) < static_cast<size_t>(n) + 1){
+        scratch.hrow_map = edge_vt();
+        scratch.hrow_map = edge_vt(Kokkos::view_alloc(Kokkos::WithoutInitializing, "hrow_map scratch"), n + 1);
+    }
+}
+
 std::list<coarse_level_triple> generate_coarse_graphs(const matrix_t fine_g, const wgt_vt vweights, experiment_data<scalar_t>& experiment, bool uniform_eweights = false) {
     std::list<coarse_level_triple> levels;
     coarse_level_triple finest;
@@ -500,11 +525,17 @@ std::list<coarse_level_triple> generate_coarse_graphs(const matrix_t fine_g, con
     finest.uniform_weights = uniform_eweights;
     finest.vtx_w = vweights;
     levels.push_back(finest);
-    pool_t rand_pool(std::time(nullptr));
-    scratch_mem scratch;
-    scratch.htable = vtx_vt(Kokkos::view_alloc(Kokkos::WithoutInitializing, "htable scratch"), fine_g.nnz());
-    scratch.hvals = wgt_vt(Kokkos::view_alloc(Kokkos::WithoutInitializing, "hvals scratch"), fine_g.nnz());
-    scratch.hrow_map = edge_vt(Kokkos::view_alloc(Kokkos::WithoutInitializing, "hrow_map scratch"), fine_g.numRows() + 1);
+    //a fixed seed restarts the random stream so that the hierarchy is reproducible
+    //otherwise the stream continues from the previous call
+    if(seed != 0){
+        rand_pool = pool_t(seed);
+        has_pool = true;
+    } else if(!has_pool){
+        //concurrent attempts may start within the same second, so the time alone is not a good seed
+        rand_pool = pool_t((static_cast<uint64_t>(std::time(nullptr)) << 32) ^ std::random_device()());
+        has_pool = true;
+    }
+    reserve_scratch(fine_g.numRows(), fine_g.nnz());
     while (levels.rbegin()->mtx.numRows() > coarse_vtx_cutoff) {
 
         coarse_level_triple current_level = *levels.rbegin();
@@ -517,7 +548,7 @@ std::list<coarse_level_triple> generate_coarse_graphs(const matrix_t fine_g, con
 
         Kokkos::Timer timer;
         coarse_level_triple next_level = build_coarse_graph(current_level, interp_graph, scratch, experiment);
-        Kokkos::fence();
+        exec.fence();
         experiment.addMeasurement(Measurement::Build, timer.seconds());
         timer.reset();
 
@@ -548,6 +579,15 @@ void set_max_levels(unsigned int _max_levels) {
     this->max_levels = _max_levels;
 }
 
+void set_seed(uint64_t _seed) {
+    this->seed = _seed;
+}
+
+void set_exec_space(const exec_space& _exec) {
+    this->exec = _exec;
+    this->mapper.exec = _exec;
+}
+
 };
 
 }
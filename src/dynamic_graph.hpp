@@ -0,0 +1,763 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#pragma once
+#include <utility>
+#include <iostream>
+#include <Kokkos_Sort.hpp>
+#include "jet.h"
+#include "part_stat.hpp"
+#include "partitioner.hpp"
+
+namespace jet_partitioner {
+
+//a graph and a partition of it that change by batches of edge and vertex updates
+//rows keep spare capacity so that insertions rarely move the adjacency, and after each batch
+//only the vertices it touched and the neighbors of moved vertices are refined,
+//so the work per batch follows the size of the batch rather than the size of the graph
+template<class crsMat, typename part_t>
+class dynamic_partitioner {
+public:
+
+    using matrix_t = crsMat;
+    using exec_space = typename matrix_t::execution_space;
+    using Device = typename matrix_t::device_type;
+    using ordinal_t = typename matrix_t::ordinal_type;
+    using edge_offset_t = typename matrix_t::size_type;
+    using scalar_t = typename matrix_t::value_type;
+    using graph_t = typename matrix_t::staticcrsgraph_type;
+    using stat = part_stat<matrix_t, part_t>;
+    using gain_t = typename stat::gain_t;
+    using vtx_vt = Kokkos::View<ordinal_t*, Device>;
+    using vtx_svt = Kokkos::View<ordinal_t, Device>;
+    using wgt_vt = Kokkos::View<scalar_t*, Device>;
+    using edge_vt = Kokkos::View<edge_offset_t*, Device>;
+    using part_vt = Kokkos::View<part_t*, Device>;
+    using gain_vt = Kokkos::View<gain_t*, Device>;
+    using key_vt = Kokkos::View<uint64_t*, Device>;
+    using policy_t = Kokkos::RangePolicy<exec_space>;
+    using partitioner_t = partitioner<matrix_t, part_t>;
+    static constexpr part_t NULL_PART = -1;
+    //batch edges are sorted by keys that pack a vertex id into 32 bits
+    static_assert(sizeof(ordinal_t) <= 4, "dynamic graphs require 32-bit vertex ids");
+    //spare entries given to each row when the adjacency is laid out
+    static constexpr edge_offset_t min_slack = 4;
+    //refinement rounds per batch, each round visits the vertices around the previous round's moves
+    static constexpr int max_rounds = 12;
+
+    exec_space exec;
+    config_t config;
+    part_t k = 0;
+    ordinal_t n = 0;
+    //vertices that the per-vertex arrays have room for
+    ordinal_t n_cap = 0;
+    //row i holds row_len(i) entries starting at row_start(i), with room up to row_start(i + 1)
+    edge_vt row_start, row_len;
+    vtx_vt entries;
+    wgt_vt values;
+    wgt_vt vtx_w;
+    part_vt part;
+    gain_vt part_sizes;
+    gain_t total_size = 0;
+    gain_t size_max = 0;
+    //counts each cut edge from both sides, like the refiner
+    gain_t cut = 0;
+    //frontier, candidate and move membership is marked with the current stamp, so marks never need to be cleared
+    ordinal_t stamp = 0;
+    vtx_vt mark, cand_mark, move_mark;
+    vtx_vt frontier, next_frontier, moved;
+    vtx_svt frontier_count;
+    part_vt dest, old_part;
+    gain_vt cand_gain;
+    edge_vt pending;
+    //part connectivity tables of the frontier vertices
+    edge_vt conn_start;
+    part_vt conn_parts;
+    gain_vt conn_wgts;
+    //used when local refinement can not restore balance
+    typename partitioner_t::workspace ws;
+
+template<class view_t>
+static view_t grown(const view_t& v, size_t size, const exec_space& space){
+    view_t x(v.label(), size);
+    if(v.extent(0) > 0) Kokkos::deep_copy(space, Kokkos::subview(x, std::make_pair(static_cast<size_t>(0), v.extent(0))), v);
+    return x;
+}
+
+KOKKOS_INLINE_FUNCTION
+static void add_frontier(const vtx_vt& marks, const vtx_vt& list, const vtx_svt& count, const ordinal_t s, const ordinal_t v){
+    if(marks(v) != s && Kokkos::atomic_exchange(&marks(v), s) != s){
+        list(Kokkos::atomic_fetch_add(&count(), 1)) = v;
+    }
+}
+
+KOKKOS_INLINE_FUNCTION
+static ordinal_t key_row(const uint64_t key){
+    return static_cast<ordinal_t>(key >> 32);
+}
+
+//the other endpoint of a directed batch entry, entry 2i is src(i) -> dst(i) and 2i + 1 is dst(i) -> src(i)
+KOKKOS_INLINE_FUNCTION
+static ordinal_t key_col(const uint64_t key, const vtx_vt& src, const vtx_vt& dst){
+    uint64_t pos = key & 0xffffffff;
+    return (pos % 2 == 0) ? dst(pos / 2) : src(pos / 2);
+}
+
+KOKKOS_INLINE_FUNCTION
+static gain_t lookup(const part_vt& parts, const gain_vt& wgts, const edge_offset_t start, const edge_offset_t size, const part_t p){
+    if(size == 0) return 0;
+    edge_offset_t slot = p % size;
+    for(edge_offset_t x = 0; x < size; x++){
+        part_t px = parts(start + slot);
+        if(px == p) return wgts(start + slot);
+        if(px == NULL_PART) return 0;
+        slot = (slot + 1) % size;
+    }
+    return 0;
+}
+
+void init(const config_t& _config, const matrix_t g, const wgt_vt vweights, const part_vt initial, const exec_space& _exec){
+    exec = _exec;
+    config = _config;
+    config.verbose = false;
+    config.dump_coarse = false;
+    k = config.num_parts;
+    n = g.numRows();
+    n_cap = 0;
+    stamp = 0;
+    //copy the input without spare capacity, relayout adds it
+    row_start = edge_vt(Kokkos::ViewAllocateWithoutInitializing("row start"), n + 1);
+    Kokkos::deep_copy(exec, row_start, g.graph.row_map);
+    row_len = edge_vt("row length", n);
+    edge_vt len = row_len;
+    Kokkos::parallel_for("row lengths", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i){
+        len(i) = g.graph.row_map(i + 1) - g.graph.row_map(i);
+    });
+    entries = vtx_vt(Kokkos::ViewAllocateWithoutInitializing("entries"), g.nnz());
+    Kokkos::deep_copy(exec, entries, g.graph.entries);
+    values = wgt_vt(Kokkos::ViewAllocateWithoutInitializing("values"), g.nnz());
+    Kokkos::deep_copy(exec, values, g.values);
+    vtx_w = wgt_vt(Kokkos::ViewAllocateWithoutInitializing("vertex weights"), n);
+    Kokkos::deep_copy(exec, vtx_w, vweights);
+    part = part_vt(Kokkos::ViewAllocateWithoutInitializing("partition"), n);
+    Kokkos::deep_copy(exec, part, initial);
+    vtx_vt empty;
+    mark = cand_mark = move_mark = frontier = next_frontier = moved = empty;
+    dest = old_part = part_vt();
+    cand_gain = gain_vt();
+    pending = conn_start = edge_vt();
+    frontier_count = vtx_svt("frontier count");
+    relayout(n + n / 8 + 64, edge_vt());
+    part_sizes = stat::get_part_sizes(g, vweights, initial, k, exec);
+    total_size = stat::get_total_size(g, vweights, exec);
+    cut = stat::get_total_cut(g, initial, exec);
+}
+
+//moves the adjacency into a new layout with rows for new_cap vertices and extra(i) more entries in row i
+//each row gets a quarter of its length, but at least min_slack, as spare capacity
+//costs time in the size of the graph, but rows only overflow after many insertions
+void relayout(ordinal_t new_cap, edge_vt extra){
+    bool has_extra = extra.extent(0) > 0;
+    edge_vt len = row_len;
+    edge_vt old_start = row_start;
+    vtx_vt old_entries = entries;
+    wgt_vt old_values = values;
+    ordinal_t old_rows = len.extent(0);
+    edge_vt new_start(Kokkos::ViewAllocateWithoutInitializing("row start"), new_cap + 1);
+    edge_offset_t total = 0;
+    Kokkos::parallel_scan("layout rows", policy_t(exec, 0, new_cap + 1), KOKKOS_LAMBDA(const ordinal_t i, edge_offset_t& update, const bool final){
+        if(final){
+            new_start(i) = update;
+        }
+        if(i < new_cap){
+            edge_offset_t need = i < old_rows ? len(i) : 0;
+            if(has_extra && i < old_rows) need += extra(i);
+            edge_offset_t slack = need / 4;
+            if(slack < min_slack) slack = min_slack;
+            update += need + slack;
+        }
+    }, total);
+    vtx_vt new_entries(Kokkos::ViewAllocateWithoutInitializing("entries"), total);
+    wgt_vt new_values(Kokkos::ViewAllocateWithoutInitializing("values"), total);
+    Kokkos::parallel_for("move rows", policy_t(exec, 0, old_rows), KOKKOS_LAMBDA(const ordinal_t i){
+        for(edge_offset_t j = 0; j < len(i); j++){
+            new_entries(new_start(i) + j) = old_entries(old_start(i) + j);
+            new_values(new_start(i) + j) = old_values(old_start(i) + j);
+        }
+    });
+    row_start = new_start;
+    entries = new_entries;
+    values = new_values;
+    if(new_cap != n_cap){
+        row_len = grown(row_len, new_cap, exec);
+        vtx_w = grown(vtx_w, new_cap, exec);
+        part = grown(part, new_cap, exec);
+        mark = grown(mark, new_cap, exec);
+        cand_mark = grown(cand_mark, new_cap, exec);
+        move_mark = grown(move_mark, new_cap, exec);
+        pending = grown(pending, new_cap, exec);
+        dest = part_vt(Kokkos::ViewAllocateWithoutInitializing("destination"), new_cap);
+        old_part = part_vt(Kokkos::ViewAllocateWithoutInitializing("previous part"), new_cap);
+        cand_gain = gain_vt(Kokkos::ViewAllocateWithoutInitializing("candidate gain"), new_cap);
+        frontier = vtx_vt(Kokkos::ViewAllocateWithoutInitializing("frontier"), new_cap);
+        next_frontier = vtx_vt(Kokkos::ViewAllocateWithoutInitializing("next frontier"), new_cap);
+        moved = vtx_vt(Kokkos::ViewAllocateWithoutInitializing("moved"), new_cap);
+        conn_start = edge_vt(Kokkos::ViewAllocateWithoutInitializing("conn start"), new_cap + 1);
+        n_cap = new_cap;
+    }
+}
+
+//sorts both directions of a batch of edges by their source vertex
+//a key holds the source above the position of the directed entry in the batch
+key_vt sorted_directions(const vtx_vt& src, const vtx_vt& dst){
+    ordinal_t b = src.extent(0);
+    key_vt keys(Kokkos::ViewAllocateWithoutInitializing("batch keys"), 2*b);
+    Kokkos::parallel_for("batch keys", policy_t(exec, 0, b), KOKKOS_LAMBDA(const ordinal_t i){
+        keys(2*i) = (static_cast<uint64_t>(src(i)) << 32) | static_cast<uint64_t>(2*i);
+        keys(2*i + 1) = (static_cast<uint64_t>(dst(i)) << 32) | static_cast<uint64_t>(2*i + 1);
+    });
+    if(b > 0) Kokkos::sort(exec, keys);
+    return keys;
+}
+
+//the first position of each row in sorted keys
+vtx_vt segment_starts(const key_vt& keys, ordinal_t& segments){
+    ordinal_t total = keys.extent(0);
+    vtx_vt starts(Kokkos::ViewAllocateWithoutInitializing("segment starts"), total);
+    segments = 0;
+    Kokkos::parallel_scan("find segments", policy_t(exec, 0, total), KOKKOS_LAMBDA(const ordinal_t j, ordinal_t& update, const bool final){
+        if(j == 0 || key_row(keys(j)) != key_row(keys(j - 1))){
+            if(final){
+                starts(update) = j;
+            }
+            update++;
+        }
+    }, segments);
+    return starts;
+}
+
+void delete_edges(const vtx_vt& src, const vtx_vt& dst){
+    key_vt keys = sorted_directions(src, dst);
+    ordinal_t segments = 0;
+    vtx_vt starts = segment_starts(keys, segments);
+    ordinal_t total = keys.extent(0);
+    edge_vt rs = row_start, len = row_len;
+    vtx_vt e = entries, marks = mark, list = frontier;
+    wgt_vt vals = values;
+    part_vt p = part;
+    vtx_svt count = frontier_count;
+    ordinal_t s = stamp;
+    gain_t removed = 0;
+    //one thread per row, so rows can be compacted without atomics
+    Kokkos::parallel_reduce("delete edges", policy_t(exec, 0, segments), KOKKOS_LAMBDA(const ordinal_t x, gain_t& update){
+        ordinal_t j = starts(x);
+        ordinal_t row = key_row(keys(j));
+        edge_offset_t start = rs(row);
+        for(; j < total && key_row(keys(j)) == row; j++){
+            ordinal_t col = key_col(keys(j), src, dst);
+            edge_offset_t end = start + len(row);
+            for(edge_offset_t y = start; y < end; y++){
+                if(e(y) == col){
+                    if(p(row) != p(col)) update += vals(y);
+                    e(y) = e(end - 1);
+                    vals(y) = vals(end - 1);
+                    len(row)--;
+                    break;
+                }
+            }
+        }
+        add_frontier(marks, list, count, s, row);
+    }, removed);
+    cut -= removed;
+}
+
+void insert_edges(const vtx_vt& src, const vtx_vt& dst, const wgt_vt& wgts){
+    key_vt keys = sorted_directions(src, dst);
+    ordinal_t segments = 0;
+    vtx_vt starts = segment_starts(keys, segments);
+    ordinal_t total = keys.extent(0);
+    //rows that would overflow get room first
+    edge_vt extra = pending;
+    ordinal_t overflow = 0;
+    {
+        edge_vt rs = row_start, len = row_len;
+        Kokkos::parallel_reduce("count insertions", policy_t(exec, 0, segments), KOKKOS_LAMBDA(const ordinal_t x, ordinal_t& update){
+            ordinal_t j = starts(x);
+            ordinal_t row = key_row(keys(j));
+            edge_offset_t c = 0;
+            for(; j < total && key_row(keys(j)) == row; j++){
+                c++;
+            }
+            extra(row) = c;
+            if(len(row) + c > rs(row + 1) - rs(row)) update++;
+        }, overflow);
+    }
+    if(overflow > 0) relayout(n_cap, extra);
+    edge_vt rs = row_start, len = row_len;
+    vtx_vt e = entries, marks = mark, list = frontier;
+    wgt_vt vals = values;
+    vtx_svt count = frontier_count;
+    ordinal_t s = stamp;
+    Kokkos::parallel_for("insert edges", policy_t(exec, 0, segments), KOKKOS_LAMBDA(const ordinal_t x){
+        ordinal_t j = starts(x);
+        ordinal_t row = key_row(keys(j));
+        edge_offset_t start = rs(row);
+        extra(row) = 0;
+        for(; j < total && key_row(keys(j)) == row; j++){
+            ordinal_t col = key_col(keys(j), src, dst);
+            scalar_t w = wgts((keys(j) & 0xffffffff) / 2);
+            if(col == row) continue;
+            edge_offset_t end = start + len(row);
+            edge_offset_t y = start;
+            while(y < end && e(y) != col){
+                y++;
+            }
+            if(y < end){
+                vals(y) += w;
+            } else {
+                e(end) = col;
+                vals(end) = w;
+                len(row)++;
+            }
+        }
+        add_frontier(marks, list, count, s, row);
+    });
+}
+
+//adds new vertices with weight 1 and no part, growing the per-vertex arrays if needed
+void add_vertices(ordinal_t count){
+    if(n + count > n_cap) relayout(std::max(2*n_cap, n + count), edge_vt());
+    wgt_vt w = vtx_w;
+    part_vt p = part;
+    Kokkos::parallel_for("add vertices", policy_t(exec, n, n + count), KOKKOS_LAMBDA(const ordinal_t i){
+        w(i) = 1;
+        p(i) = NULL_PART;
+    });
+    n += count;
+    total_size += count;
+}
+
+void set_weights(const vtx_vt& vertices, const wgt_vt& weights){
+    wgt_vt w = vtx_w;
+    part_vt p = part;
+    gain_vt ps = part_sizes;
+    vtx_vt marks = mark, list = frontier;
+    vtx_svt count = frontier_count;
+    ordinal_t s = stamp;
+    gain_t delta = 0;
+    Kokkos::parallel_reduce("set vertex weights", policy_t(exec, 0, vertices.extent(0)), KOKKOS_LAMBDA(const ordinal_t x, gain_t& update){
+        ordinal_t v = vertices(x);
+        gain_t d = weights(x) - w(v);
+        w(v) = weights(x);
+        if(p(v) != NULL_PART) Kokkos::atomic_add(&ps(p(v)), d);
+        update += d;
+        add_frontier(marks, list, count, s, v);
+    }, delta);
+    total_size += delta;
+}
+
+//new vertices join the part of their heaviest assigned neighbor, or the smallest part
+void assign_new(ordinal_t first){
+    using min_loc_t = Kokkos::MinLoc<gain_t, part_t>;
+    typename min_loc_t::value_type smallest;
+    gain_vt ps = part_sizes;
+    Kokkos::parallel_reduce("find smallest part", policy_t(exec, 0, k), KOKKOS_LAMBDA(const part_t q, typename min_loc_t::value_type& update){
+        if(ps(q) < update.val){
+            update.val = ps(q);
+            update.loc = q;
+        }
+    }, min_loc_t(smallest));
+    part_t fallback = smallest.loc;
+    edge_vt rs = row_start, len = row_len;
+    vtx_vt e = entries, marks = mark, list = frontier;
+    wgt_vt vals = values, w = vtx_w;
+    part_vt p = part;
+    vtx_svt count = frontier_count;
+    ordinal_t s = stamp;
+    Kokkos::parallel_for("assign new vertices", policy_t(exec, first, n), KOKKOS_LAMBDA(const ordinal_t i){
+        part_t best = fallback;
+        scalar_t best_w = 0;
+        for(edge_offset_t j = rs(i); j < rs(i) + len(i); j++){
+            part_t pj = p(e(j));
+            if(pj != NULL_PART && vals(j) > best_w){
+                best = pj;
+                best_w = vals(j);
+            }
+        }
+        p(i) = best;
+        Kokkos::atomic_add(&ps(best), static_cast<gain_t>(w(i)));
+        add_frontier(marks, list, count, s, i);
+    });
+}
+
+gain_t inserted_cut(const vtx_vt& src, const vtx_vt& dst, const wgt_vt& wgts){
+    part_vt p = part;
+    gain_t added = 0;
+    Kokkos::parallel_reduce("cut of inserted edges", policy_t(exec, 0, src.extent(0)), KOKKOS_LAMBDA(const ordinal_t i, gain_t& update){
+        if(src(i) != dst(i) && p(src(i)) != p(dst(i))) update += 2*wgts(i);
+    }, added);
+    return added;
+}
+
+//builds an open addressing table of part connectivity for each frontier vertex, sized min(degree, k)
+void build_conn(ordinal_t fsize){
+    edge_vt rs = row_start, len = row_len, cs = conn_start;
+    vtx_vt e = entries, list = frontier;
+    wgt_vt vals = values;
+    part_vt p = part;
+    part_t parts = k;
+    edge_offset_t total = 0;
+    Kokkos::parallel_scan("conn table offsets", policy_t(exec, 0, fsize + 1), KOKKOS_LAMBDA(const ordinal_t f, edge_offset_t& update, const bool final){
+        if(final){
+            cs(f) = update;
+        }
+        if(f < fsize){
+            edge_offset_t size = len(list(f));
+            if(size > static_cast<edge_offset_t>(parts)) size = parts;
+            update += size;
+        }
+    }, total);
+    if(static_cast<size_t>(total) > conn_parts.extent(0)){
+        conn_parts = part_vt(Kokkos::ViewAllocateWithoutInitializing("conn parts"), 2*total);
+        conn_wgts = gain_vt(Kokkos::ViewAllocateWithoutInitializing("conn weights"), 2*total);
+    }
+    part_vt cp = conn_parts;
+    gain_vt cw = conn_wgts;
+    Kokkos::parallel_for("build conn tables", policy_t(exec, 0, fsize), KOKKOS_LAMBDA(const ordinal_t f){
+        ordinal_t v = list(f);
+        edge_offset_t start = cs(f);
+        edge_offset_t size = cs(f + 1) - start;
+        for(edge_offset_t x = start; x < start + size; x++){
+            cp(x) = NULL_PART;
+            cw(x) = 0;
+        }
+        for(edge_offset_t j = rs(v); j < rs(v) + len(v); j++){
+            part_t pj = p(e(j));
+            edge_offset_t slot = pj % size;
+            while(cp(start + slot) != NULL_PART && cp(start + slot) != pj){
+                slot = (slot + 1) % size;
+            }
+            cp(start + slot) = pj;
+            cw(start + slot) += vals(j);
+        }
+    });
+}
+
+//moves frontier vertices to the connected part with the largest gain that has room
+//a second pass keeps a move only if it still gains when better moves of its neighbors are made first
+ordinal_t lp_round(ordinal_t fsize){
+    edge_vt rs = row_start, len = row_len, cs = conn_start;
+    vtx_vt e = entries, list = frontier, cmark = cand_mark, mv = moved;
+    wgt_vt vals = values, w = vtx_w;
+    part_vt p = part, d = dest, cp = conn_parts;
+    gain_vt cw = conn_wgts, cg = cand_gain, ps = part_sizes;
+    gain_t limit = size_max;
+    ordinal_t s = ++stamp;
+    Kokkos::parallel_for("find lp moves", policy_t(exec, 0, fsize), KOKKOS_LAMBDA(const ordinal_t f){
+        ordinal_t v = list(f);
+        part_t pv = p(v);
+        edge_offset_t start = cs(f);
+        edge_offset_t size = cs(f + 1) - start;
+        gain_t own = lookup(cp, cw, start, size, pv);
+        part_t best = pv;
+        gain_t best_gain = 0;
+        for(edge_offset_t x = start; x < start + size; x++){
+            part_t px = cp(x);
+            if(px != NULL_PART && px != pv && cw(x) - own > best_gain && ps(px) + w(v) <= limit){
+                best = px;
+                best_gain = cw(x) - own;
+            }
+        }
+        if(best != pv){
+            d(v) = best;
+            cg(v) = best_gain;
+            cmark(v) = s;
+        }
+    });
+    ordinal_t count = 0;
+    Kokkos::parallel_scan("filter lp moves", policy_t(exec, 0, fsize), KOKKOS_LAMBDA(const ordinal_t f, ordinal_t& update, const bool final){
+        ordinal_t v = list(f);
+        if(cmark(v) != s) return;
+        part_t pv = p(v);
+        part_t dv = d(v);
+        gain_t gv = cg(v);
+        gain_t change = 0;
+        for(edge_offset_t j = rs(v); j < rs(v) + len(v); j++){
+            ordinal_t u = e(j);
+            part_t pu = p(u);
+            if(cmark(u) == s && (cg(u) > gv || (cg(u) == gv && u < v))){
+                pu = d(u);
+            }
+            if(pu == dv) change += vals(j);
+            if(pu == pv) change -= vals(j);
+        }
+        if(change > 0){
+            if(final){
+                mv(update) = v;
+            }
+            update++;
+        }
+    }, count);
+    return apply_moves(count, s);
+}
+
+//moves frontier vertices out of oversized parts into connected parts with room
+ordinal_t rebalance_round(ordinal_t fsize){
+    gain_vt excess(Kokkos::ViewAllocateWithoutInitializing("excess"), k);
+    gain_vt ps = part_sizes;
+    gain_t limit = size_max;
+    Kokkos::parallel_for("part excess", policy_t(exec, 0, k), KOKKOS_LAMBDA(const part_t q){
+        excess(q) = ps(q) - limit;
+    });
+    edge_vt cs = conn_start;
+    vtx_vt list = frontier, mv = moved;
+    wgt_vt w = vtx_w;
+    part_vt p = part, d = dest, cp = conn_parts;
+    gain_vt cw = conn_wgts;
+    ordinal_t s = ++stamp;
+    ordinal_t count = 0;
+    Kokkos::parallel_scan("find rebalance moves", policy_t(exec, 0, fsize), KOKKOS_LAMBDA(const ordinal_t f, ordinal_t& update, const bool final){
+        ordinal_t v = list(f);
+        part_t pv = p(v);
+        if(excess(pv) <= 0) return;
+        edge_offset_t start = cs(f);
+        edge_offset_t size = cs(f + 1) - start;
+        part_t best = pv;
+        gain_t best_conn = -1;
+        for(edge_offset_t x = start; x < start + size; x++){
+            part_t px = cp(x);
+            if(px != NULL_PART && px != pv && cw(x) > best_conn && ps(px) + w(v) <= limit){
+                best = px;
+                best_conn = cw(x);
+            }
+        }
+        if(best != pv){
+            if(final){
+                d(v) = best;
+                mv(update) = v;
+            }
+            update++;
+        }
+    }, count);
+    //only evict while the part is still oversized
+    Kokkos::parallel_for("reserve evictions", policy_t(exec, 0, count), KOKKOS_LAMBDA(const ordinal_t x){
+        ordinal_t v = mv(x);
+        part_t pv = p(v);
+        if(Kokkos::atomic_fetch_sub(&excess(pv), static_cast<gain_t>(w(v))) <= 0){
+            Kokkos::atomic_add(&excess(pv), static_cast<gain_t>(w(v)));
+            d(v) = pv;
+        }
+    });
+    return apply_moves(count, s);
+}
+
+//moves the vertices in moved to dest if the destination stays within the size limit
+//then updates the cut and collects the moved vertices and their neighbors as the next frontier
+ordinal_t apply_moves(ordinal_t count, ordinal_t s){
+    edge_vt rs = row_start, len = row_len;
+    vtx_vt e = entries, mmark = move_mark, mv = moved, marks = mark, next = next_frontier;
+    wgt_vt vals = values, w = vtx_w;
+    part_vt p = part, d = dest, op = old_part;
+    gain_vt ps = part_sizes;
+    gain_t limit = size_max;
+    Kokkos::parallel_for("apply moves", policy_t(exec, 0, count), KOKKOS_LAMBDA(const ordinal_t x){
+        ordinal_t v = mv(x);
+        part_t pv = p(v);
+        part_t dv = d(v);
+        if(dv == pv) return;
+        gain_t wv = w(v);
+        if(Kokkos::atomic_fetch_add(&ps(dv), wv) + wv > limit){
+            Kokkos::atomic_add(&ps(dv), -wv);
+            return;
+        }
+        Kokkos::atomic_add(&ps(pv), -wv);
+        op(v) = pv;
+        p(v) = dv;
+        mmark(v) = s;
+    });
+    vtx_svt next_count = frontier_count;
+    Kokkos::deep_copy(exec, next_count, 0);
+    ordinal_t fs = ++stamp;
+    gain_t delta = 0;
+    Kokkos::parallel_reduce("cut change of moves", policy_t(exec, 0, count), KOKKOS_LAMBDA(const ordinal_t x, gain_t& update){
+        ordinal_t v = mv(x);
+        if(mmark(v) != s) return;
+        add_frontier(marks, next, next_count, fs, v);
+        for(edge_offset_t j = rs(v); j < rs(v) + len(v); j++){
+            ordinal_t u = e(j);
+            bool u_moved = mmark(u) == s;
+            part_t old_u = u_moved ? op(u) : p(u);
+            gain_t change = vals(j)*(static_cast<int>(p(v) != p(u)) - static_cast<int>(op(v) != old_u));
+            //an edge between two moved vertices is counted once from each side
+            update += u_moved ? change : 2*change;
+            add_frontier(marks, next, next_count, fs, u);
+        }
+    }, delta);
+    cut += delta;
+    ordinal_t fsize = 0;
+    Kokkos::deep_copy(exec, fsize, next_count);
+    exec.fence();
+    std::swap(frontier, next_frontier);
+    return fsize;
+}
+
+//refines the frontier and the neighborhood of each round's moves until nothing moves
+void refine_local(){
+    ordinal_t fsize = 0;
+    Kokkos::deep_copy(exec, fsize, frontier_count);
+    exec.fence();
+    for(int round = 0; round < max_rounds && fsize > 0; round++){
+        build_conn(fsize);
+        if(stat::largest_part_size(part_sizes, exec) > size_max){
+            fsize = rebalance_round(fsize);
+        } else {
+            fsize = lp_round(fsize);
+        }
+    }
+    if(stat::largest_part_size(part_sizes, exec) > size_max) refine_global();
+}
+
+//local rounds could not restore balance, so the whole partition is refined
+void refine_global(){
+    matrix_t g = to_matrix();
+    wgt_vt w = Kokkos::subview(vtx_w, std::make_pair(static_cast<ordinal_t>(0), n));
+    part_vt p = Kokkos::subview(part, std::make_pair(static_cast<ordinal_t>(0), n));
+    experiment_data<scalar_t> experiment;
+    scalar_t edge_cut = 0;
+    partitioner_t::refine(edge_cut, config, g, w, false, p, experiment, exec, &ws);
+    cut = 2*static_cast<gain_t>(edge_cut);
+    Kokkos::deep_copy(exec, part_sizes, stat::get_part_sizes(g, w, p, k, exec));
+}
+
+//applies a batch of changes in this order: new vertices, deletions, insertions, vertex weights
+//then refines the partition around the touched vertices and returns the edge cut
+gain_t apply(const vtx_vt& ins_src, const vtx_vt& ins_dst, const wgt_vt& ins_wgt,
+    const vtx_vt& del_src, const vtx_vt& del_dst, const vtx_vt& weight_vtx, const wgt_vt& weight_val, ordinal_t new_vertices){
+
+    ordinal_t first_new = n;
+    if(new_vertices > 0) add_vertices(new_vertices);
+    Kokkos::deep_copy(exec, frontier_count, 0);
+    stamp++;
+    if(del_src.extent(0) > 0) delete_edges(del_src, del_dst);
+    if(ins_src.extent(0) > 0) insert_edges(ins_src, ins_dst, ins_wgt);
+    if(weight_vtx.extent(0) > 0) set_weights(weight_vtx, weight_val);
+    if(new_vertices > 0) assign_new(first_new);
+    if(ins_src.extent(0) > 0) cut += inserted_cut(ins_src, ins_dst, ins_wgt);
+    size_max = stat::optimal_size(static_cast<ordinal_t>(total_size), k)*config.max_imb_ratio;
+    refine_local();
+#ifdef DEBUG
+    verify();
+#endif
+    return cut / 2;
+}
+
+//recomputes the cut, part sizes and total size from scratch and compares them with the maintained values
+//prints each difference and returns false if there is any
+bool verify() const {
+    matrix_t g = to_matrix();
+    part_vt p = current_part();
+    wgt_vt w = Kokkos::subview(vtx_w, std::make_pair(static_cast<ordinal_t>(0), n));
+    gain_t actual_cut = stat::get_total_cut(g, p, exec);
+    gain_t actual_total = stat::get_total_size(g, w, exec);
+    gain_vt actual_sizes = stat::get_part_sizes(g, w, p, k, exec);
+    gain_vt sizes = part_sizes;
+    part_t wrong_sizes = 0;
+    Kokkos::parallel_reduce("compare part sizes", policy_t(exec, 0, k), KOKKOS_LAMBDA(const part_t x, part_t& update){
+        if(sizes(x) != actual_sizes(x)) update++;
+    }, wrong_sizes);
+    ordinal_t unassigned = 0;
+    Kokkos::parallel_reduce("find unassigned vertices", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update){
+        if(p(i) == NULL_PART) update++;
+    }, unassigned);
+    bool ok = true;
+    if(actual_cut != cut){
+        std::cerr << "Dynamic graph cut is " << cut / 2 << " but the graph has a cut of " << actual_cut / 2 << std::endl;
+        ok = false;
+    }
+    if(actual_total != total_size){
+        std::cerr << "Dynamic graph total size is " << total_size << " but the vertex weights sum to " << actual_total << std::endl;
+        ok = false;
+    }
+    if(wrong_sizes > 0){
+        std::cerr << "Dynamic graph has wrong sizes for " << wrong_sizes << " of " << k << " parts" << std::endl;
+        ok = false;
+    }
+    if(unassigned > 0){
+        std::cerr << "Dynamic graph has " << unassigned << " vertices without a part" << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+//a compact copy of the current graph
+matrix_t to_matrix() const {
+    edge_vt len = row_len, rs = row_start;
+    vtx_vt e = entries;
+    wgt_vt vals = values;
+    edge_vt rows(Kokkos::ViewAllocateWithoutInitializing("rows"), n + 1);
+    edge_offset_t nnz = 0;
+    ordinal_t rows_n = n;
+    Kokkos::parallel_scan("compact row map", policy_t(exec, 0, n + 1), KOKKOS_LAMBDA(const ordinal_t i, edge_offset_t& update, const bool final){
+        if(final){
+            rows(i) = update;
+        }
+        if(i < rows_n) update += len(i);
+    }, nnz);
+    vtx_vt out_entries(Kokkos::ViewAllocateWithoutInitializing("entries"), nnz);
+    wgt_vt out_values(Kokkos::ViewAllocateWithoutInitializing("values"), nnz);
+    Kokkos::parallel_for("compact rows", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i){
+        for(edge_offset_t j = 0; j < len(i); j++){
+            out_entries(rows(i) + j) = e(rs(i) + j);
+            out_values(rows(i) + j) = vals(rs(i) + j);
+        }
+    });
+    graph_t graph(out_entries, rows);
+    return matrix_t("dynamic graph", n, out_values, graph);
+}
+
+part_vt current_part() const {
+    return Kokkos::subview(part, std::make_pair(static_cast<ordinal_t>(0), n));
+}
+};
+
+//a dynamic graph holds the state for the standard graph types on the default device
+struct dynamic_graph::impl {
+    dynamic_partitioner<matrix_t, part_t> state;
+};
+
+}
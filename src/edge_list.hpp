@@ -0,0 +1,232 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#pragma once
+#include <limits>
+#include <iostream>
+#include <Kokkos_Core.hpp>
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "heuristics.hpp"
+
+namespace jet_partitioner {
+
+//how the weights of repeated edges are combined
+//only repeats of the same directed pair are combined, the two directions of an edge are merged by keeping the larger weight
+//so an edge listed as both (u, v) and (v, u) keeps its weight
+//sum adds every occurrence
+//max keeps the largest weight
+//first keeps the weight of the occurrence that appears earliest in the input
+enum class duplicate_rule { sum, max, first };
+
+//builds a symmetric csr graph without duplicate edges or self loops from a list of edges
+//each edge (u, v, w) is inserted into the rows of both u and v
+//repeated entries within a row are merged in a per-row hash table, similar to contract.hpp
+//the slot for v in the row of u holds the weight of the directed pair (u, v), which is then merged with (v, u)
+template<class crsMat>
+class edge_list_builder {
+public:
+
+    // define internal types
+    using matrix_t = crsMat;
+    using exec_space = typename matrix_t::execution_space;
+    using Device = typename matrix_t::device_type;
+    using ordinal_t = typename matrix_t::ordinal_type;
+    using edge_offset_t = typename matrix_t::size_type;
+    using scalar_t = typename matrix_t::value_type;
+    using vtx_vt = Kokkos::View<ordinal_t*, Device>;
+    using wgt_vt = Kokkos::View<scalar_t*, Device>;
+    using edge_vt = Kokkos::View<edge_offset_t*, Device>;
+    using index_vt = Kokkos::View<size_t*, Device>;
+    using graph_t = typename matrix_t::staticcrsgraph_type;
+    using policy_t = Kokkos::RangePolicy<exec_space>;
+    static constexpr ordinal_t get_null_val() {
+        if (std::is_signed<ordinal_t>::value) {
+            return -1;
+        } else {
+            return std::numeric_limits<ordinal_t>::max();
+        }
+    }
+    static constexpr ordinal_t NULL_KEY = get_null_val();
+
+KOKKOS_INLINE_FUNCTION
+static edge_offset_t insert(const vtx_vt& htable, const edge_offset_t hash_start, const edge_offset_t size, const ordinal_t u){
+    edge_offset_t offset = abs(xorshiftHash<ordinal_t>(u)) % size;
+    while(true){
+        ordinal_t v = htable(hash_start + offset);
+        if(v == NULL_KEY){
+            v = Kokkos::atomic_compare_exchange(&htable(hash_start + offset), NULL_KEY, u);
+        }
+        if(v == u || v == NULL_KEY){
+            return hash_start + offset;
+        }
+        offset++;
+        if(offset >= size) offset -= size;
+    }
+}
+
+//returns the slot of u in a hash table row that is known to contain u
+KOKKOS_INLINE_FUNCTION
+static edge_offset_t find(const vtx_vt& htable, const edge_offset_t hash_start, const edge_offset_t size, const ordinal_t u){
+    edge_offset_t offset = abs(xorshiftHash<ordinal_t>(u)) % size;
+    while(htable(hash_start + offset) != u){
+        offset++;
+        if(offset >= size) offset -= size;
+    }
+    return hash_start + offset;
+}
+
+//converts per-row counts stored in x(0..n-1) into row offsets in x(0..n)
+//x(n) must be zero beforehand and holds the total afterwards
+static edge_offset_t exclusive_scan(const edge_vt x, const ordinal_t n){
+    Kokkos::parallel_scan("edge list offsets", policy_t(0, n + 1), KOKKOS_LAMBDA(const ordinal_t i, edge_offset_t& update, const bool final){
+        const edge_offset_t val = x(i);
+        if(final){
+            x(i) = update;
+        }
+        update += val;
+    });
+    edge_offset_t total = 0;
+    Kokkos::deep_copy(total, Kokkos::subview(x, n));
+    return total;
+}
+
+//src, dst and wgts describe the input edges; vertex ids must lie in [0, n)
+//duplicates are merged according to rule and self loops are dropped, weights must be positive
+//uniform_ew is set if every resulting edge weight is 1
+static bool build(const ordinal_t n, const vtx_vt src, const vtx_vt dst, const wgt_vt wgts, const duplicate_rule rule,
+    matrix_t& g, bool& uniform_ew){
+    const size_t edges = src.extent(0);
+    if(2*edges > static_cast<size_t>(std::numeric_limits<edge_offset_t>::max())){
+        std::cerr << "FATAL ERROR: " << edges << " edges exceed the capacity of the graph's offset type" << std::endl;
+        return false;
+    }
+    //each row gets a hash table with space for every edge incident on it
+    edge_vt hrow_map("hash row map", n + 1);
+    Kokkos::parallel_for("count edge list degrees", policy_t(0, edges), KOKKOS_LAMBDA(const size_t e){
+        const ordinal_t u = src(e);
+        const ordinal_t v = dst(e);
+        if(u != v){
+            Kokkos::atomic_add(&hrow_map(u), static_cast<edge_offset_t>(1));
+            Kokkos::atomic_add(&hrow_map(v), static_cast<edge_offset_t>(1));
+        }
+    });
+    const edge_offset_t hash_size = exclusive_scan(hrow_map, n);
+    vtx_vt htable(Kokkos::ViewAllocateWithoutInitializing("hashtable keys"), hash_size);
+    Kokkos::deep_copy(htable, NULL_KEY);
+    //a direction that never appears keeps a weight of 0
+    wgt_vt hvals("hashtable values", hash_size);
+    index_vt hfirst;
+    if(rule == duplicate_rule::first){
+        hfirst = index_vt(Kokkos::ViewAllocateWithoutInitializing("hashtable first occurrence"), hash_size);
+        Kokkos::deep_copy(hfirst, std::numeric_limits<size_t>::max());
+    }
+    Kokkos::parallel_for("insert edge list", policy_t(0, edges), KOKKOS_LAMBDA(const size_t e){
+        const ordinal_t u = src(e);
+        const ordinal_t v = dst(e);
+        if(u == v) return;
+        for(int side = 0; side < 2; side++){
+            const ordinal_t x = side == 0 ? u : v;
+            const ordinal_t y = side == 0 ? v : u;
+            const edge_offset_t hash_start = hrow_map(x);
+            const edge_offset_t j = insert(htable, hash_start, hrow_map(x + 1) - hash_start, y);
+            //the row of v only needs the key, its slot holds the weight of (v, u)
+            if(side == 1) continue;
+            if(rule == duplicate_rule::sum){
+                Kokkos::atomic_add(&hvals(j), wgts(e));
+            } else if(rule == duplicate_rule::max){
+                Kokkos::atomic_max(&hvals(j), wgts(e));
+            } else {
+                Kokkos::atomic_min(&hfirst(j), e);
+            }
+        }
+    });
+    if(rule == duplicate_rule::first){
+        Kokkos::parallel_for("resolve first edge weights", policy_t(0, hash_size), KOKKOS_LAMBDA(const edge_offset_t j){
+            if(htable(j) != NULL_KEY && hfirst(j) != std::numeric_limits<size_t>::max()){
+                hvals(j) = wgts(hfirst(j));
+            }
+        });
+    }
+    //each undirected edge is merged by the row of its smaller endpoint, which writes both slots
+    Kokkos::parallel_for("merge edge directions", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i){
+        for(edge_offset_t j = hrow_map(i); j < hrow_map(i + 1); j++){
+            const ordinal_t y = htable(j);
+            if(y != NULL_KEY && y > i){
+                const edge_offset_t hash_start = hrow_map(y);
+                const edge_offset_t r = find(htable, hash_start, hrow_map(y + 1) - hash_start, i);
+                const scalar_t w = hvals(j) > hvals(r) ? hvals(j) : hvals(r);
+                hvals(j) = w;
+                hvals(r) = w;
+            }
+        }
+    });
+    edge_vt row_map("row map", n + 1);
+    Kokkos::parallel_for("count unique edges", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i){
+        edge_offset_t uniques = 0;
+        for(edge_offset_t j = hrow_map(i); j < hrow_map(i + 1); j++){
+            if(htable(j) != NULL_KEY){
+                uniques++;
+            }
+        }
+        row_map(i) = uniques;
+    });
+    const edge_offset_t nnz = exclusive_scan(row_map, n);
+    vtx_vt entries(Kokkos::ViewAllocateWithoutInitializing("entries"), nnz);
+    wgt_vt values(Kokkos::ViewAllocateWithoutInitializing("values"), nnz);
+    Kokkos::parallel_for("consolidate unique edges", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i){
+        edge_offset_t write_to = row_map(i);
+        for(edge_offset_t j = hrow_map(i); j < hrow_map(i + 1); j++){
+            if(htable(j) != NULL_KEY){
+                entries(write_to) = htable(j);
+                values(write_to) = hvals(j);
+                write_to++;
+            }
+        }
+    });
+    edge_offset_t non_unit = 0;
+    Kokkos::parallel_reduce("check uniform weights", policy_t(0, nnz), KOKKOS_LAMBDA(const edge_offset_t j, edge_offset_t& update){
+        if(values(j) != 1) update++;
+    }, non_unit);
+    uniform_ew = (non_unit == 0);
+    graph_t g_graph(entries, row_map);
+    g = matrix_t("input graph", n, values, g_graph);
+    return true;
+}
+};
+
+}
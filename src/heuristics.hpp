@@ -85,6 +85,9 @@ public:
         vtx_vt map;
     };
 
+    //instance that runs the coarsening kernels, set by the contracter
+    exec_space exec;
+
     //hn is a list of vertices such that vertex i wants to aggregate with vertex hn(i)
     ordinal_t parallel_map_construct(vtx_vt vcmap, const ordinal_t n, const vtx_vt vperm, const vtx_vt hn) {
 
@@ -98,7 +101,7 @@ public:
             vtx_vt next_perm("next perm", perm_length);
             Kokkos::View<ordinal_t, Device> next_length("next_length");
 
-            Kokkos::parallel_for(policy_t(0, perm_length), KOKKOS_LAMBDA(ordinal_t i) {
+            Kokkos::parallel_for(policy_t(exec, 0, perm_length), KOKKOS_LAMBDA(ordinal_t i) {
                 ordinal_t u = perm_length == n ? i : curr_perm(i);
                 ordinal_t v = hn(u);
                 int condition = u < v;
@@ -124,10 +127,10 @@ public:
                     }
                 }
             });
-            Kokkos::fence();
+            exec.fence();
             //add the ones that failed to be reprocessed next round
             //maybe count these then create next_perm to save memory?
-            Kokkos::parallel_scan(policy_t(0, perm_length), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final) {
+            Kokkos::parallel_scan(policy_t(exec, 0, perm_length), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final) {
                 ordinal_t u = curr_perm(i);
                 if (vcmap(u) >= n) {
                     if(final){
@@ -139,12 +142,13 @@ public:
                     next_length() = update;
                 }
             });
-            Kokkos::fence();
+            exec.fence();
             swap = swap ^ 1;
-            Kokkos::deep_copy(perm_length, next_length);
+            Kokkos::deep_copy(exec, perm_length, next_length);
+            exec.fence();
             curr_perm = next_perm;
         }
-        Kokkos::parallel_scan("assign aggregates", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t u, ordinal_t& update, const bool final){
+        Kokkos::parallel_scan("assign aggregates", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t u, ordinal_t& update, const bool final){
             if(vcmap(u) == u){
                 if(final){
                     vcmap(u) = update;
@@ -157,14 +161,15 @@ public:
                 nvertices_coarse() = update;
             }
         });
-        Kokkos::parallel_for("propagate aggregates", policy_t(0, n), KOKKOS_LAMBDA(ordinal_t u) {
+        Kokkos::parallel_for("propagate aggregates", policy_t(exec, 0, n), KOKKOS_LAMBDA(ordinal_t u) {
             if(vcmap(u) >= n) {
                 ordinal_t c_id = vcmap(u) - n;
                 vcmap(u) = vcmap(c_id);
             }
         });
         ordinal_t nc = 0;
-        Kokkos::deep_copy(nc, nvertices_coarse);
+        Kokkos::deep_copy(exec, nc, nvertices_coarse);
+        exec.fence();
         return nc;
     }
 
@@ -180,14 +185,14 @@ public:
 
         vtx_vt vcmap("vcmap", n);
 
-        Kokkos::parallel_for("initialize vcmap", policy_t(0, n), KOKKOS_LAMBDA(ordinal_t i) {
+        Kokkos::parallel_for("initialize vcmap", policy_t(exec, 0, n), KOKKOS_LAMBDA(ordinal_t i) {
             vcmap(i) = ORD_MAX;
         });
 
         Kokkos::Timer timer;
 
         vtx_vt vperm("vperm", n);
-        Kokkos::parallel_for("initialize vperm", policy_t(0, n), KOKKOS_LAMBDA(ordinal_t i) {
+        Kokkos::parallel_for("initialize vperm", policy_t(exec, 0, n), KOKKOS_LAMBDA(ordinal_t i) {
             vperm(i) = i;
         });
 
@@ -196,7 +201,7 @@ public:
 
         if (uniform_weights) {
             //all weights equal at this level so choose heaviest edge randomly
-            Kokkos::parallel_for("Random HN", policy_t(0, n), KOKKOS_LAMBDA(ordinal_t i) {
+            Kokkos::parallel_for("Random HN", policy_t(exec, 0, n), KOKKOS_LAMBDA(ordinal_t i) {
                 gen_t generator = rand_pool.get_state();
                 ordinal_t adj_size = g.graph.row_map(i + 1) - g.graph.row_map(i);
                 if(adj_size > 0){
@@ -210,12 +215,12 @@ public:
         }
         else {
             scalar_t sum_v_w = 0;
-            Kokkos::parallel_reduce("calc max", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i, scalar_t& update){
+            Kokkos::parallel_reduce("calc max", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i, scalar_t& update){
                 scalar_t wgt = vtx_w(i);
                 update += wgt;
             }, sum_v_w);
             scalar_t max_allowed = 6*sum_v_w / n;
-            Kokkos::parallel_for("Heaviest HN", team_policy_t(n, Kokkos::AUTO), KOKKOS_LAMBDA(const member & thread) {
+            Kokkos::parallel_for("Heaviest HN", team_policy_t(exec, n, Kokkos::AUTO), KOKKOS_LAMBDA(const member & thread) {
                 ordinal_t i = thread.league_rank();
                 ordinal_t adj_size = g.graph.row_map(i + 1) - g.graph.row_map(i);
                 if(adj_size > 0 && vtx_w(i) < max_allowed){
@@ -264,7 +269,7 @@ public:
     ordinal_t countUnmatched(vtx_vt target) {
         ordinal_t total = 0;
 
-        Kokkos::parallel_reduce("count unmatched", policy_t(0, target.extent(0)), KOKKOS_LAMBDA(ordinal_t i, ordinal_t& update) {
+        Kokkos::parallel_reduce("count unmatched", policy_t(exec, 0, target.extent(0)), KOKKOS_LAMBDA(ordinal_t i, ordinal_t& update) {
             if (target(i) == ORD_MAX) {
                 update++;
             }
@@ -278,9 +283,9 @@ public:
         ordinal_t mappable = unmappedVtx.extent(0);
         Kokkos::View<hash_t*, Device> htable(Kokkos::ViewAllocateWithoutInitializing("hashes hash table"), mappable);
         vtx_vt twins(Kokkos::ViewAllocateWithoutInitializing("twin table"), mappable);
-        Kokkos::deep_copy(htable, nullkey);
-        Kokkos::deep_copy(twins, -1);
-        Kokkos::parallel_for("match by hash", policy_t(0, mappable), KOKKOS_LAMBDA(const ordinal_t x){
+        Kokkos::deep_copy(exec, htable, nullkey);
+        Kokkos::deep_copy(exec, twins, -1);
+        Kokkos::parallel_for("match by hash", policy_t(exec, 0, mappable), KOKKOS_LAMBDA(const ordinal_t x){
             ordinal_t i = unmappedVtx(x);
             hash_t h = hashes(x);
             ordinal_t key = h % mappable;
@@ -432,14 +437,14 @@ public:
 
         vtx_vt hn(Kokkos::ViewAllocateWithoutInitializing("heavies"), n);
         vtx_vt vcmap(Kokkos::ViewAllocateWithoutInitializing("vcmap"), n);
-        Kokkos::deep_copy(hn, ORD_MAX);
-        Kokkos::deep_copy(vcmap, ORD_MAX);
+        Kokkos::deep_copy(exec, hn, ORD_MAX);
+        Kokkos::deep_copy(exec, vcmap, ORD_MAX);
         vtx_vt vperm_scratch(Kokkos::ViewAllocateWithoutInitializing("vperm"), n);
         vtx_vt vperm = vperm_scratch;
 
         if (uniform_weights) {
             //all weights equal at this level so choose heaviest edge randomly
-            Kokkos::parallel_for("Potential matches (random)", policy_t(0, n), KOKKOS_LAMBDA(ordinal_t i) {
+            Kokkos::parallel_for("Potential matches (random)", policy_t(exec, 0, n), KOKKOS_LAMBDA(ordinal_t i) {
                 ordinal_t adj_size = g.graph.row_map(i + 1) - g.graph.row_map(i);
                 if(adj_size == 0) return;
                 gen_t generator = rand_pool.get_state();
@@ -451,9 +456,9 @@ public:
         else {
             pickMatch<true, false> matcher(g, vcmap, hn, rand_pool, vperm, n, n);
             if(!is_host_space && g.nnz() / g.numRows() > 32){
-                Kokkos::parallel_for("Potential matches (heavy)", team_policy_t(n, Kokkos::AUTO), matcher);
+                Kokkos::parallel_for("Potential matches (heavy)", team_policy_t(exec, n, Kokkos::AUTO), matcher);
             } else {
-                Kokkos::parallel_for("Potential matches (heavy)", policy_t(0, n), matcher);
+                Kokkos::parallel_for("Potential matches (heavy)", policy_t(exec, 0, n), matcher);
             }
         }
         ordinal_t perm_length = n;
@@ -467,7 +472,7 @@ public:
                 // vary the hash with r so that the active/inactive sets change greatly between phases
                 // we want to match as many vertices as possible according to hn to avoid computing new matches
                 // this approach seems to produce higher qualtiy partitions than a maximal independent set induced by hn
-                Kokkos::parallel_for("commit matches (part 1)", policy_t(0, perm_length), KOKKOS_LAMBDA(ordinal_t i){
+                Kokkos::parallel_for("commit matches (part 1)", policy_t(exec, 0, perm_length), KOKKOS_LAMBDA(ordinal_t i){
                     ordinal_t u = perm_length == n ? i : vperm(i);
                     ordinal_t v = hn(u);
                     if(v == ORD_MAX || vcmap(u) != ORD_MAX) return;
@@ -482,7 +487,7 @@ public:
                         vcmap(u) = ORD_MAX - 1;
                     }
                 });
-                Kokkos::parallel_for("commit matches (part 2)", policy_t(0, perm_length), KOKKOS_LAMBDA(ordinal_t i){
+                Kokkos::parallel_for("commit matches (part 2)", policy_t(exec, 0, perm_length), KOKKOS_LAMBDA(ordinal_t i){
                     ordinal_t u = perm_length == n ? i : vperm(i);
                     ordinal_t v = hn(u);
                     if(v == ORD_MAX || vcmap(u) != ORD_MAX) return;
@@ -491,7 +496,7 @@ public:
                         vcmap(u) = cv;
                     }
                 });
-                Kokkos::parallel_for("commit matches (part 3)", policy_t(0, perm_length), KOKKOS_LAMBDA(ordinal_t i){
+                Kokkos::parallel_for("commit matches (part 3)", policy_t(exec, 0, perm_length), KOKKOS_LAMBDA(ordinal_t i){
                     ordinal_t u = perm_length == n ? i : vperm(i);
                     if(vcmap(u) == ORD_MAX - 1){
                         vcmap(u) = ORD_MAX;
@@ -503,24 +508,24 @@ public:
             if(uniform_weights){
                 pickMatch<false, true> matcher(g, vcmap, hn, rand_pool, vperm, n, perm_length);
                 if(!is_host_space && g.nnz() / g.numRows() > 32){
-                    Kokkos::parallel_for("Potential matches (random)", team_policy_t(perm_length, Kokkos::AUTO), matcher);
+                    Kokkos::parallel_for("Potential matches (random)", team_policy_t(exec, perm_length, Kokkos::AUTO), matcher);
                 } else {
-                    Kokkos::parallel_for("Potential matches (random)", policy_t(0, perm_length), matcher);
+                    Kokkos::parallel_for("Potential matches (random)", policy_t(exec, 0, perm_length), matcher);
                 }
             } else {
                 pickMatch<false, false> matcher(g, vcmap, hn, rand_pool, vperm, n, perm_length);
                 if(!is_host_space && g.nnz() / g.numRows() > 32){
-                    Kokkos::parallel_for("Potential matches (heavy)", team_policy_t(perm_length, Kokkos::AUTO), matcher);
+                    Kokkos::parallel_for("Potential matches (heavy)", team_policy_t(exec, perm_length, Kokkos::AUTO), matcher);
                 } else {
-                    Kokkos::parallel_for("Potential matches (heavy)", policy_t(0, perm_length), matcher);
+                    Kokkos::parallel_for("Potential matches (heavy)", policy_t(exec, 0, perm_length), matcher);
                 }
             }
             vtx_vt perm = perm_scratch;
             if(perm_length != n){
                 perm = Kokkos::subview(perm_scratch, std::make_pair((ordinal_t)0, perm_length));
-                Kokkos::deep_copy(exec_space(), perm, vperm);
+                Kokkos::deep_copy(exec, perm, vperm);
             }
-            Kokkos::parallel_scan("scan remaining", policy_t(0, perm_length), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
+            Kokkos::parallel_scan("scan remaining", policy_t(exec, 0, perm_length), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
                 ordinal_t u = perm_length == n ? i : perm(i);
                 if(vcmap(u) == ORD_MAX && hn(u) != ORD_MAX){
                     if(final){
@@ -540,7 +545,7 @@ public:
             if (unmappedRatio > 0.25) {
                 vtx_vt unmappedVtx(Kokkos::ViewAllocateWithoutInitializing("unmapped vertices"), unmapped);
                 ordinal_t mappable;
-                Kokkos::parallel_scan("scan unmapped", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
+                Kokkos::parallel_scan("scan unmapped", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
                     if(vcmap(i) == ORD_MAX && g.graph.row_map(i+1) - g.graph.row_map(i) == 1){
                         if(final){
                             unmappedVtx(update) = i;
@@ -550,7 +555,7 @@ public:
                 }, mappable);
                 unmappedVtx = Kokkos::subview(unmappedVtx, std::make_pair((ordinal_t)0, mappable));
                 vtx_vt hashes(Kokkos::ViewAllocateWithoutInitializing("hashes"), mappable);
-                Kokkos::parallel_for("create digests", policy_t(0, mappable), KOKKOS_LAMBDA(ordinal_t i) {
+                Kokkos::parallel_for("create digests", policy_t(exec, 0, mappable), KOKKOS_LAMBDA(ordinal_t i) {
                     ordinal_t u = unmappedVtx(i);
                     ordinal_t v = g.graph.entries(g.graph.row_map(u));
                     hashes(i) = v;
@@ -566,7 +571,7 @@ public:
             if (unmappedRatio > 0.25) {
                 vtx_vt unmappedVtx(Kokkos::ViewAllocateWithoutInitializing("unmapped vertices"), unmapped);
                 Kokkos::View<uint64_t*, Device> hashes(Kokkos::ViewAllocateWithoutInitializing("hashes"), unmapped);
-                Kokkos::parallel_scan("scan unmapped", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
+                Kokkos::parallel_scan("scan unmapped", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
                     if(vcmap(i) == ORD_MAX){
                         if(final){
                             unmappedVtx(update) = i;
@@ -577,7 +582,7 @@ public:
 
                 //compute (order independent) digests of adjacency lists
                 //if two digests are equal, we assume the two adjacency lists are equal (may not always be true)
-                Kokkos::parallel_for("create digests", team_policy_t(unmapped, Kokkos::AUTO), KOKKOS_LAMBDA(const member & thread) {
+                Kokkos::parallel_for("create digests", team_policy_t(exec, unmapped, Kokkos::AUTO), KOKKOS_LAMBDA(const member & thread) {
                     ordinal_t u = unmappedVtx(thread.league_rank());
                     uint64_t hash = 0;
                     hasher_t hasher;
@@ -603,7 +608,7 @@ public:
             if (unmappedRatio > 0.25) {
                 vtx_vt unmappedVtx(Kokkos::ViewAllocateWithoutInitializing("unmapped vertices"), unmapped);
                 ordinal_t mappable;
-                Kokkos::parallel_scan("scan unmapped", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
+                Kokkos::parallel_scan("scan unmapped", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
                     if(vcmap(i) == ORD_MAX){
                         if(final){
                             unmappedVtx(update) = i;
@@ -612,7 +617,7 @@ public:
                     }
                 }, mappable);
                 vtx_vt hashes(Kokkos::ViewAllocateWithoutInitializing("hashes"), mappable);
-                Kokkos::parallel_for("create digests", policy_t(0, mappable), KOKKOS_LAMBDA(ordinal_t i) {
+                Kokkos::parallel_for("create digests", policy_t(exec, 0, mappable), KOKKOS_LAMBDA(ordinal_t i) {
                     ordinal_t u = unmappedVtx(i);
                     ordinal_t h = ORD_MAX;
                     scalar_t max_wgt = 0;
@@ -641,14 +646,14 @@ public:
         }
 
         //create singleton aggregates of remaining unmatched vertices
-        Kokkos::parallel_for(policy_t(0, n), KOKKOS_LAMBDA(ordinal_t i){
+        Kokkos::parallel_for(policy_t(exec, 0, n), KOKKOS_LAMBDA(ordinal_t i){
             if (vcmap(i) == ORD_MAX) {
                 vcmap(i) = i;
             }
         });
         ordinal_t nc = 0;
         //if something breaks here it's probably cuz adding n causes overflow
-        Kokkos::parallel_scan("set coarse ids", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
+        Kokkos::parallel_scan("set coarse ids", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
             if(vcmap(i) == i){
                 if(final){
                     vcmap(i) = update;
@@ -658,7 +663,7 @@ public:
                 vcmap(i) += n;
             }
         }, nc);
-        Kokkos::parallel_for("prop coarse ids", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i){
+        Kokkos::parallel_for("prop coarse ids", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i){
             if(vcmap(i) >= n){
                 vcmap(i) = vcmap(vcmap(i) - n);
             }
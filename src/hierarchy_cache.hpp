@@ -0,0 +1,143 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#pragma once
+#include <string>
+#include <list>
+#include <cstdio>
+#include <cstdint>
+#include <thread>
+#include <functional>
+#include <unistd.h>
+#include <Kokkos_Core.hpp>
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "contract.hpp"
+#include "binary_dump.hpp"
+#include "mapped_file.hpp"
+
+namespace jet_partitioner {
+
+//on-disk cache of coarse hierarchies, keyed by a hash of the input graph and the coarsening settings
+//entries are hierarchy files written by binary_dump without the finest graph
+template<class crsMat, typename part_t>
+class hierarchy_cache {
+public:
+    // define internal types
+    using matrix_t = crsMat;
+    using exec_space = typename matrix_t::execution_space;
+    using Device = typename matrix_t::device_type;
+    using ordinal_t = typename matrix_t::ordinal_type;
+    using edge_offset_t = typename matrix_t::size_type;
+    using scalar_t = typename matrix_t::value_type;
+    using wgt_vt = Kokkos::View<scalar_t*, Device>;
+    using part_vt = Kokkos::View<part_t*, Device>;
+    using policy_t = Kokkos::RangePolicy<exec_space>;
+    using clt = typename contracter<matrix_t>::coarse_level_triple;
+    using dump_t = binary_dump<matrix_t, part_t>;
+
+//splitmix64 finalizer
+KOKKOS_INLINE_FUNCTION
+static uint64_t mix(uint64_t z){
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+//hashes the values of a view in parallel on the device
+//each value is mixed with its index so that the terms can be summed in any order
+template<class view_t>
+static uint64_t hash_view(const view_t v, uint64_t h, const exec_space& exec){
+    uint64_t sum = 0;
+    Kokkos::parallel_reduce("hash view", policy_t(exec, 0, v.extent(0)), KOKKOS_LAMBDA(const size_t i, uint64_t& update){
+        update += mix(static_cast<uint64_t>(v(i)) + (i + 1) * 0x9e3779b97f4a7c15ull);
+    }, sum);
+    return mix(h + sum + v.extent(0));
+}
+
+//cache key for a graph and the settings that determine its coarsening
+static uint64_t key(const matrix_t g, const wgt_vt vweights, bool uniform_ew,
+    int heuristic, uint64_t seed, ordinal_t cutoff, ordinal_t min_allowed, unsigned int max_levels, const exec_space& exec = exec_space()){
+    uint64_t h = mix(sizeof(ordinal_t) | (sizeof(edge_offset_t) << 8) | (sizeof(scalar_t) << 16));
+    h = hash_view(g.graph.row_map, h, exec);
+    h = hash_view(g.graph.entries, h, exec);
+    h = hash_view(g.values, h, exec);
+    h = hash_view(vweights, h, exec);
+    for(uint64_t x : {static_cast<uint64_t>(uniform_ew), static_cast<uint64_t>(heuristic), seed,
+        static_cast<uint64_t>(cutoff), static_cast<uint64_t>(min_allowed), static_cast<uint64_t>(max_levels)}){
+        h = mix(h + x);
+    }
+    return h;
+}
+
+static std::string path(const char* dir, uint64_t key){
+    char name[32];
+    snprintf(name, sizeof(name), "jet_%016llx.hier", static_cast<unsigned long long>(key));
+    return std::string(dir) + "/" + name;
+}
+
+//loads the cached hierarchy at path into levels if it exists
+//finest is used as the first level; f must outlive levels
+static bool load(const std::string& path, mapped_file& f, const clt& finest, std::list<clt>& levels){
+    if(access(path.c_str(), R_OK) != 0) return false;
+    part_vt unused;
+    if(!dump_t::load_coarse(path.c_str(), f, levels, unused, &finest)){
+        levels.clear();
+        f.close();
+        return false;
+    }
+    return true;
+}
+
+//writes levels to path
+//the file is written under a temporary name and renamed so that readers never see a partial entry
+//the name is unique per thread because concurrent attempts may store the same entry
+static bool store(const std::string& path, const std::list<clt>& levels){
+    std::string tmp = path + ".tmp" + std::to_string(getpid()) + "_" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    if(!dump_t::dump_coarse(tmp.c_str(), levels, part_vt(), true)){
+        remove(tmp.c_str());
+        return false;
+    }
+    if(rename(tmp.c_str(), path.c_str()) != 0){
+        remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+};
+
+}
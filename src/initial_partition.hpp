@@ -42,6 +42,7 @@
 #include <numeric>
 #include <random>
 #include <type_traits>
+#include <mutex>
 #include "metis.h"
 #include <Kokkos_Core.hpp>
 #include "KokkosSparse_CrsMatrix.hpp"
@@ -67,39 +68,47 @@ public:
     using metis_mt = typename metis_vt::HostMirror;
     using policy_t = Kokkos::RangePolicy<exec_space>;
 
+static std::mutex& metis_mutex(){
+    static std::mutex m;
+    return m;
+}
+
 template <class dst_vt, class src_vt>
-static void copy(dst_vt dst, src_vt src){
-    Kokkos::parallel_for("copy", policy_t(0, src.extent(0)), KOKKOS_LAMBDA(const int i){
+static void copy(dst_vt dst, src_vt src, const exec_space& exec){
+    Kokkos::parallel_for("copy", policy_t(exec, 0, src.extent(0)), KOKKOS_LAMBDA(const int i){
         dst(i) = src(i);
     });
 }
 
 template <class src_vt>
-static metis_mt to_metis_int(src_vt src){
+static metis_mt to_metis_int(src_vt src, const exec_space& exec){
     using src_t = std::remove_cv_t<typename src_vt::value_type>;
     int n = src.extent(0);
     metis_mt data(Kokkos::ViewAllocateWithoutInitializing("metis int host"), n);
     if(std::is_same_v<metis_int, src_t>){
-        Kokkos::deep_copy(data, src);
+        Kokkos::deep_copy(exec, data, src);
     } else {
         metis_vt data_dev(Kokkos::ViewAllocateWithoutInitializing("metis int dev"), n);
-        copy<metis_vt, src_vt>(data_dev, src);
-        Kokkos::deep_copy(data, data_dev);
+        copy<metis_vt, src_vt>(data_dev, src, exec);
+        Kokkos::deep_copy(exec, data, data_dev);
     }
+    exec.fence();
     return data;
 }
 
-static part_vt metis_init(matrix_t g, wgt_vt vtx_w, int k, double imb_ratio){
+static part_vt metis_init(matrix_t g, wgt_vt vtx_w, int k, double imb_ratio, const exec_space& exec = exec_space()){
     int n = g.numRows();
     metis_vt part_metis("part metis type", n);
     metis_mt pm = Kokkos::create_mirror_view(part_metis);
-    metis_mt vtx_wm = to_metis_int<wgt_vt>(vtx_w);
-    metis_mt xadj = to_metis_int<typename matrix_t::row_map_type>(g.graph.row_map);
-    metis_mt adjcwgt = to_metis_int<wgt_vt>(g.values);
-    metis_mt adjncy = to_metis_int<vtx_vt>(g.graph.entries);
+    metis_mt vtx_wm = to_metis_int<wgt_vt>(vtx_w, exec);
+    metis_mt xadj = to_metis_int<typename matrix_t::row_map_type>(g.graph.row_map, exec);
+    metis_mt adjcwgt = to_metis_int<wgt_vt>(g.values, exec);
+    metis_mt adjncy = to_metis_int<vtx_vt>(g.graph.entries, exec);
     real_t imbalance = imb_ratio;
     int ec = 0;
     int nweights = 1;
+    //concurrent attempts share one metis library, which is not guaranteed to be reentrant
+    std::unique_lock<std::mutex> lock(metis_mutex());
     int ret = METIS_PartGraphKway(&n, &nweights, xadj.data(), adjncy.data(),
 				       vtx_wm.data(), NULL, adjcwgt.data(), &k, NULL,
 				       &imbalance, NULL, &ec, pm.data());
@@ -107,22 +116,26 @@ static part_vt metis_init(matrix_t g, wgt_vt vtx_w, int k, double imb_ratio){
         std::cerr << "Metis could not partition coarsest graph. Exiting..." << std::endl;
         exit(-1);
     }
-    Kokkos::deep_copy(part_metis, pm);
+    lock.unlock();
+    Kokkos::deep_copy(exec, part_metis, pm);
     part_vt part("part", n);
-    copy<part_vt, metis_vt>(part, part_metis);
+    copy<part_vt, metis_vt>(part, part_metis, exec);
+    //pm is freed on return
+    exec.fence();
     return part;
 }
 
-static part_vt random_init(wgt_vt vtx_w, int k, double imb_ratio){
+static part_vt random_init(wgt_vt vtx_w, int k, double imb_ratio, const exec_space& exec = exec_space()){
     ordinal_t n = vtx_w.extent(0);
     scalar_t total = 0;
-    Kokkos::parallel_reduce("sum vtx", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i, scalar_t& update){
+    Kokkos::parallel_reduce("sum vtx", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i, scalar_t& update){
         update += vtx_w(i);
     }, total);
     scalar_t opt = total / k;
     scalar_t upper = opt * imb_ratio;
     wgt_mt vw = Kokkos::create_mirror_view(vtx_w);
-    Kokkos::deep_copy(vw, vtx_w);
+    Kokkos::deep_copy(exec, vw, vtx_w);
+    exec.fence();
     part_vt part_dev("part device", n);
     part_mt part = Kokkos::create_mirror_view(part_dev);
     wgt_mt psizes("part sizes", k);
@@ -144,7 +157,8 @@ static part_vt random_init(wgt_vt vtx_w, int k, double imb_ratio){
         part(i) = p;
         psizes(p) += size;
     }
-    Kokkos::deep_copy(part_dev, part);
+    Kokkos::deep_copy(exec, part_dev, part);
+    exec.fence();
     return part_dev;
 }
 
@@ -39,19 +39,27 @@
 
 #include "jet_defs.h"
 #include "partitioner.hpp"
+#include "context.hpp"
+#include "dynamic_graph.hpp"
 #include "experiment_data.hpp"
 #include "jet_config.h"
 
 namespace jet_partitioner {
 
+context::context() : data(std::make_unique<impl>()) {}
+
+context::~context() = default;
+
 part_vt partition(value_t& edge_cut,
                 const config_t& config,
                 const matrix_t g,
                 const wgt_vt vweights,
                 bool uniform_ew,
-                experiment_data<value_t>& experiment){
+                experiment_data<value_t>& experiment,
+                const Device& exec,
+                context* ctx){
     
-    return partitioner<matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment);
+    return partitioner<matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment, exec, context_workspace<matrix_t, part_t>(ctx));
 }
 
 part_mt partition_host(value_t& edge_cut,
@@ -59,9 +67,11 @@ part_mt partition_host(value_t& edge_cut,
                 const host_matrix_t g,
                 const wgt_host_vt vweights,
                 bool uniform_ew,
-                experiment_data<value_t>& experiment){
+                experiment_data<value_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
 
-    return partitioner<host_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment);
+    return partitioner<host_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment, exec, context_workspace<host_matrix_t, part_t>(ctx));
 }
 
 part_mt partition_serial(value_t& edge_cut,
@@ -69,9 +79,234 @@ part_mt partition_serial(value_t& edge_cut,
                 const serial_matrix_t g,
                 const wgt_serial_vt vweights,
                 bool uniform_ew,
-                experiment_data<value_t>& experiment){
+                experiment_data<value_t>& experiment,
+                const Kokkos::Serial& exec,
+                context* ctx){
     
-    return partitioner<serial_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment);
+    return partitioner<serial_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment, exec, context_workspace<serial_matrix_t, part_t>(ctx));
+}
+
+std::vector<part_vt> partition_batch(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<matrix_t>& graphs,
+                const std::vector<wgt_vt>& vweights,
+                const std::vector<bool>& uniform_ew,
+                int instances,
+                double& seconds){
+
+    auto parts = partitioner<matrix_t, part_t>::partition_batch(edge_cuts, config, graphs, vweights, uniform_ew, instances, seconds);
+    return std::vector<part_vt>(parts.begin(), parts.end());
+}
+
+std::vector<part_mt> partition_host_batch(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<host_matrix_t>& graphs,
+                const std::vector<wgt_host_vt>& vweights,
+                const std::vector<bool>& uniform_ew,
+                int instances,
+                double& seconds){
+
+    auto parts = partitioner<host_matrix_t, part_t>::partition_batch(edge_cuts, config, graphs, vweights, uniform_ew, instances, seconds);
+    return std::vector<part_mt>(parts.begin(), parts.end());
+}
+
+std::vector<part_mt> partition_serial_batch(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<serial_matrix_t>& graphs,
+                const std::vector<wgt_serial_vt>& vweights,
+                const std::vector<bool>& uniform_ew,
+                int instances,
+                double& seconds){
+
+    auto parts = partitioner<serial_matrix_t, part_t>::partition_batch(edge_cuts, config, graphs, vweights, uniform_ew, instances, seconds);
+    return std::vector<part_mt>(parts.begin(), parts.end());
+}
+
+std::vector<part_vt> partition_sweep(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const matrix_t g,
+                const wgt_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<value_t>>& experiments,
+                const Device& exec,
+                context* ctx){
+
+    auto parts = partitioner<matrix_t, part_t>::partition_sweep(edge_cuts, config, part_counts, g, vweights, uniform_ew, experiments, exec, context_workspace<matrix_t, part_t>(ctx));
+    return std::vector<part_vt>(parts.begin(), parts.end());
+}
+
+std::vector<part_mt> partition_host_sweep(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const host_matrix_t g,
+                const wgt_host_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<value_t>>& experiments,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    auto parts = partitioner<host_matrix_t, part_t>::partition_sweep(edge_cuts, config, part_counts, g, vweights, uniform_ew, experiments, exec, context_workspace<host_matrix_t, part_t>(ctx));
+    return std::vector<part_mt>(parts.begin(), parts.end());
+}
+
+std::vector<part_mt> partition_serial_sweep(std::vector<value_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const serial_matrix_t g,
+                const wgt_serial_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<value_t>>& experiments,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    auto parts = partitioner<serial_matrix_t, part_t>::partition_sweep(edge_cuts, config, part_counts, g, vweights, uniform_ew, experiments, exec, context_workspace<serial_matrix_t, part_t>(ctx));
+    return std::vector<part_mt>(parts.begin(), parts.end());
+}
+
+part_vt refine(value_t& edge_cut,
+                const config_t& config,
+                const matrix_t g,
+                const wgt_vt vweights,
+                bool uniform_ew,
+                part_vt part,
+                experiment_data<value_t>& experiment,
+                const Device& exec,
+                context* ctx){
+
+    return partitioner<matrix_t, part_t>::refine(edge_cut, config, g, vweights, uniform_ew, part, experiment, exec, context_workspace<matrix_t, part_t>(ctx));
+}
+
+part_mt refine_host(value_t& edge_cut,
+                const config_t& config,
+                const host_matrix_t g,
+                const wgt_host_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<value_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    return partitioner<host_matrix_t, part_t>::refine(edge_cut, config, g, vweights, uniform_ew, part, experiment, exec, context_workspace<host_matrix_t, part_t>(ctx));
+}
+
+part_mt refine_serial(value_t& edge_cut,
+                const config_t& config,
+                const serial_matrix_t g,
+                const wgt_serial_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<value_t>& experiment,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    return partitioner<serial_matrix_t, part_t>::refine(edge_cut, config, g, vweights, uniform_ew, part, experiment, exec, context_workspace<serial_matrix_t, part_t>(ctx));
+}
+
+std::future<partition_result<part_vt, value_t>> partition_async(const config_t& config,
+                const matrix_t g,
+                const wgt_vt vweights,
+                bool uniform_ew,
+                const Device& exec,
+                context* ctx){
+
+    return partitioner<matrix_t, part_t>::partition_async<partition_result<part_vt, value_t>>(config, g, vweights, uniform_ew, exec, context_workspace<matrix_t, part_t>(ctx));
+}
+
+std::future<partition_result<part_mt, value_t>> partition_host_async(const config_t& config,
+                const host_matrix_t g,
+                const wgt_host_vt vweights,
+                bool uniform_ew,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    return partitioner<host_matrix_t, part_t>::partition_async<partition_result<part_mt, value_t>>(config, g, vweights, uniform_ew, exec, context_workspace<host_matrix_t, part_t>(ctx));
+}
+
+std::future<partition_result<part_mt, value_t>> partition_serial_async(const config_t& config,
+                const serial_matrix_t g,
+                const wgt_serial_vt vweights,
+                bool uniform_ew,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    return partitioner<serial_matrix_t, part_t>::partition_async<partition_result<part_mt, value_t>>(config, g, vweights, uniform_ew, exec, context_workspace<serial_matrix_t, part_t>(ctx));
+}
+
+void partition_csr(value_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const edge_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const value_t* adjwgt,
+                const value_t* vwgt,
+                part_t* part,
+                experiment_data<value_t>& experiment,
+                const Device& exec,
+                context* ctx){
+
+    partitioner<matrix_t, part_t>::partition_csr(edge_cut, config, n, xadj, adjncy, adjwgt, vwgt, part, experiment, exec, context_workspace<matrix_t, part_t>(ctx));
+}
+
+void partition_host_csr(value_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const edge_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const value_t* adjwgt,
+                const value_t* vwgt,
+                part_t* part,
+                experiment_data<value_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    partitioner<host_matrix_t, part_t>::partition_csr(edge_cut, config, n, xadj, adjncy, adjwgt, vwgt, part, experiment, exec, context_workspace<host_matrix_t, part_t>(ctx));
+}
+
+void partition_serial_csr(value_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const edge_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const value_t* adjwgt,
+                const value_t* vwgt,
+                part_t* part,
+                experiment_data<value_t>& experiment,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    partitioner<serial_matrix_t, part_t>::partition_csr(edge_cut, config, n, xadj, adjncy, adjwgt, vwgt, part, experiment, exec, context_workspace<serial_matrix_t, part_t>(ctx));
+}
+
+dynamic_graph::dynamic_graph() : data(std::make_unique<impl>()) {}
+
+dynamic_graph::~dynamic_graph() = default;
+
+void init_dynamic(dynamic_graph& dg,
+                const config_t& config,
+                const matrix_t g,
+                const wgt_vt vweights,
+                const part_vt part,
+                const Device& exec){
+
+    dg.data->state.init(config, g, vweights, part, exec);
+}
+
+value_t update_dynamic(dynamic_graph& dg, const graph_update& update){
+    return dg.data->state.apply(update.insert_src, update.insert_dst, update.insert_wgt,
+        update.delete_src, update.delete_dst, update.weight_vertices, update.weight_values, update.new_vertices);
+}
+
+part_vt dynamic_partition(const dynamic_graph& dg){
+    return dg.data->state.current_part();
+}
+
+matrix_t dynamic_matrix(const dynamic_graph& dg){
+    return dg.data->state.to_matrix();
+}
+
+bool verify_dynamic(const dynamic_graph& dg){
+    return dg.data->state.verify();
 }
 
 }
\ No newline at end of file
@@ -39,6 +39,7 @@
 
 #include "jet_defs.h"
 #include "partitioner.hpp"
+#include "context.hpp"
 #include "experiment_data.hpp"
 #include "jet_config.h"
 
@@ -49,9 +50,11 @@ part_vt partition_big(big_val_t& edge_cut,
                 const big_matrix_t g,
                 const big_wgt_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment){
+                experiment_data<big_val_t>& experiment,
+                const Device& exec,
+                context* ctx){
 
-    return partitioner<big_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment);
+    return partitioner<big_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment, exec, context_workspace<big_matrix_t, part_t>(ctx));
 }
 
 part_mt partition_host_big(big_val_t& edge_cut,
@@ -59,9 +62,11 @@ part_mt partition_host_big(big_val_t& edge_cut,
                 const big_host_matrix_t g,
                 const big_wgt_host_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment){
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
 
-    return partitioner<big_host_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment);
+    return partitioner<big_host_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment, exec, context_workspace<big_host_matrix_t, part_t>(ctx));
 }
 
 part_mt partition_serial_big(big_val_t& edge_cut,
@@ -69,9 +74,167 @@ part_mt partition_serial_big(big_val_t& edge_cut,
                 const big_serial_matrix_t g,
                 const big_wgt_serial_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment){
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec,
+                context* ctx){
 
-    return partitioner<big_serial_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment);
+    return partitioner<big_serial_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment, exec, context_workspace<big_serial_matrix_t, part_t>(ctx));
+}
+
+std::vector<part_vt> partition_big_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const big_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Device& exec,
+                context* ctx){
+
+    auto parts = partitioner<big_matrix_t, part_t>::partition_sweep(edge_cuts, config, part_counts, g, vweights, uniform_ew, experiments, exec, context_workspace<big_matrix_t, part_t>(ctx));
+    return std::vector<part_vt>(parts.begin(), parts.end());
+}
+
+std::vector<part_mt> partition_host_big_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const big_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    auto parts = partitioner<big_host_matrix_t, part_t>::partition_sweep(edge_cuts, config, part_counts, g, vweights, uniform_ew, experiments, exec, context_workspace<big_host_matrix_t, part_t>(ctx));
+    return std::vector<part_mt>(parts.begin(), parts.end());
+}
+
+std::vector<part_mt> partition_serial_big_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const big_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    auto parts = partitioner<big_serial_matrix_t, part_t>::partition_sweep(edge_cuts, config, part_counts, g, vweights, uniform_ew, experiments, exec, context_workspace<big_serial_matrix_t, part_t>(ctx));
+    return std::vector<part_mt>(parts.begin(), parts.end());
+}
+
+part_vt refine_big(big_val_t& edge_cut,
+                const config_t& config,
+                const big_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                part_vt part,
+                experiment_data<big_val_t>& experiment,
+                const Device& exec,
+                context* ctx){
+
+    return partitioner<big_matrix_t, part_t>::refine(edge_cut, config, g, vweights, uniform_ew, part, experiment, exec, context_workspace<big_matrix_t, part_t>(ctx));
+}
+
+part_mt refine_host_big(big_val_t& edge_cut,
+                const config_t& config,
+                const big_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    return partitioner<big_host_matrix_t, part_t>::refine(edge_cut, config, g, vweights, uniform_ew, part, experiment, exec, context_workspace<big_host_matrix_t, part_t>(ctx));
+}
+
+part_mt refine_serial_big(big_val_t& edge_cut,
+                const config_t& config,
+                const big_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    return partitioner<big_serial_matrix_t, part_t>::refine(edge_cut, config, g, vweights, uniform_ew, part, experiment, exec, context_workspace<big_serial_matrix_t, part_t>(ctx));
+}
+
+std::future<partition_result<part_vt, big_val_t>> partition_big_async(const config_t& config,
+                const big_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                const Device& exec,
+                context* ctx){
+
+    return partitioner<big_matrix_t, part_t>::partition_async<partition_result<part_vt, big_val_t>>(config, g, vweights, uniform_ew, exec, context_workspace<big_matrix_t, part_t>(ctx));
+}
+
+std::future<partition_result<part_mt, big_val_t>> partition_host_big_async(const config_t& config,
+                const big_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    return partitioner<big_host_matrix_t, part_t>::partition_async<partition_result<part_mt, big_val_t>>(config, g, vweights, uniform_ew, exec, context_workspace<big_host_matrix_t, part_t>(ctx));
+}
+
+std::future<partition_result<part_mt, big_val_t>> partition_serial_big_async(const config_t& config,
+                const big_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    return partitioner<big_serial_matrix_t, part_t>::partition_async<partition_result<part_mt, big_val_t>>(config, g, vweights, uniform_ew, exec, context_workspace<big_serial_matrix_t, part_t>(ctx));
+}
+
+void partition_csr(big_val_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const big_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Device& exec,
+                context* ctx){
+
+    partitioner<big_matrix_t, part_t>::partition_csr(edge_cut, config, n, xadj, adjncy, adjwgt, vwgt, part, experiment, exec, context_workspace<big_matrix_t, part_t>(ctx));
+}
+
+void partition_host_csr(big_val_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const big_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    partitioner<big_host_matrix_t, part_t>::partition_csr(edge_cut, config, n, xadj, adjncy, adjwgt, vwgt, part, experiment, exec, context_workspace<big_host_matrix_t, part_t>(ctx));
+}
+
+void partition_serial_csr(big_val_t& edge_cut,
+                const config_t& config,
+                ordinal_t n,
+                const big_offset_t* xadj,
+                const ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    partitioner<big_serial_matrix_t, part_t>::partition_csr(edge_cut, config, n, xadj, adjncy, adjwgt, vwgt, part, experiment, exec, context_workspace<big_serial_matrix_t, part_t>(ctx));
 }
 
 }
\ No newline at end of file
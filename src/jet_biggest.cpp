@@ -39,6 +39,7 @@
 
 #include "jet_defs.h"
 #include "partitioner.hpp"
+#include "context.hpp"
 #include "experiment_data.hpp"
 #include "jet_config.h"
 
@@ -49,9 +50,11 @@ part_vt partition_biggest(big_val_t& edge_cut,
                 const biggest_matrix_t g,
                 const big_wgt_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment){
+                experiment_data<big_val_t>& experiment,
+                const Device& exec,
+                context* ctx){
 
-    return partitioner<biggest_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment);
+    return partitioner<biggest_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment, exec, context_workspace<biggest_matrix_t, part_t>(ctx));
 }
 
 part_mt partition_host_biggest(big_val_t& edge_cut,
@@ -59,9 +62,11 @@ part_mt partition_host_biggest(big_val_t& edge_cut,
                 const biggest_host_matrix_t g,
                 const big_wgt_host_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment){
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
 
-    return partitioner<biggest_host_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment);
+    return partitioner<biggest_host_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment, exec, context_workspace<biggest_host_matrix_t, part_t>(ctx));
 }
 
 part_mt partition_serial_biggest(big_val_t& edge_cut,
@@ -69,9 +74,167 @@ part_mt partition_serial_biggest(big_val_t& edge_cut,
                 const biggest_serial_matrix_t g,
                 const big_wgt_serial_vt vweights,
                 bool uniform_ew,
-                experiment_data<big_val_t>& experiment){
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec,
+                context* ctx){
 
-    return partitioner<biggest_serial_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment);
+    return partitioner<biggest_serial_matrix_t, part_t>::partition(edge_cut, config, g, vweights, uniform_ew, experiment, exec, context_workspace<biggest_serial_matrix_t, part_t>(ctx));
+}
+
+std::vector<part_vt> partition_biggest_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const biggest_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Device& exec,
+                context* ctx){
+
+    auto parts = partitioner<biggest_matrix_t, part_t>::partition_sweep(edge_cuts, config, part_counts, g, vweights, uniform_ew, experiments, exec, context_workspace<biggest_matrix_t, part_t>(ctx));
+    return std::vector<part_vt>(parts.begin(), parts.end());
+}
+
+std::vector<part_mt> partition_host_biggest_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const biggest_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    auto parts = partitioner<biggest_host_matrix_t, part_t>::partition_sweep(edge_cuts, config, part_counts, g, vweights, uniform_ew, experiments, exec, context_workspace<biggest_host_matrix_t, part_t>(ctx));
+    return std::vector<part_mt>(parts.begin(), parts.end());
+}
+
+std::vector<part_mt> partition_serial_biggest_sweep(std::vector<big_val_t>& edge_cuts,
+                const config_t& config,
+                const std::vector<part_t>& part_counts,
+                const biggest_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                std::vector<experiment_data<big_val_t>>& experiments,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    auto parts = partitioner<biggest_serial_matrix_t, part_t>::partition_sweep(edge_cuts, config, part_counts, g, vweights, uniform_ew, experiments, exec, context_workspace<biggest_serial_matrix_t, part_t>(ctx));
+    return std::vector<part_mt>(parts.begin(), parts.end());
+}
+
+part_vt refine_biggest(big_val_t& edge_cut,
+                const config_t& config,
+                const biggest_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                part_vt part,
+                experiment_data<big_val_t>& experiment,
+                const Device& exec,
+                context* ctx){
+
+    return partitioner<biggest_matrix_t, part_t>::refine(edge_cut, config, g, vweights, uniform_ew, part, experiment, exec, context_workspace<biggest_matrix_t, part_t>(ctx));
+}
+
+part_mt refine_host_biggest(big_val_t& edge_cut,
+                const config_t& config,
+                const biggest_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    return partitioner<biggest_host_matrix_t, part_t>::refine(edge_cut, config, g, vweights, uniform_ew, part, experiment, exec, context_workspace<biggest_host_matrix_t, part_t>(ctx));
+}
+
+part_mt refine_serial_biggest(big_val_t& edge_cut,
+                const config_t& config,
+                const biggest_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                part_mt part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    return partitioner<biggest_serial_matrix_t, part_t>::refine(edge_cut, config, g, vweights, uniform_ew, part, experiment, exec, context_workspace<biggest_serial_matrix_t, part_t>(ctx));
+}
+
+std::future<partition_result<part_vt, big_val_t>> partition_biggest_async(const config_t& config,
+                const biggest_matrix_t g,
+                const big_wgt_vt vweights,
+                bool uniform_ew,
+                const Device& exec,
+                context* ctx){
+
+    return partitioner<biggest_matrix_t, part_t>::partition_async<partition_result<part_vt, big_val_t>>(config, g, vweights, uniform_ew, exec, context_workspace<biggest_matrix_t, part_t>(ctx));
+}
+
+std::future<partition_result<part_mt, big_val_t>> partition_host_biggest_async(const config_t& config,
+                const biggest_host_matrix_t g,
+                const big_wgt_host_vt vweights,
+                bool uniform_ew,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    return partitioner<biggest_host_matrix_t, part_t>::partition_async<partition_result<part_mt, big_val_t>>(config, g, vweights, uniform_ew, exec, context_workspace<biggest_host_matrix_t, part_t>(ctx));
+}
+
+std::future<partition_result<part_mt, big_val_t>> partition_serial_biggest_async(const config_t& config,
+                const biggest_serial_matrix_t g,
+                const big_wgt_serial_vt vweights,
+                bool uniform_ew,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    return partitioner<biggest_serial_matrix_t, part_t>::partition_async<partition_result<part_mt, big_val_t>>(config, g, vweights, uniform_ew, exec, context_workspace<biggest_serial_matrix_t, part_t>(ctx));
+}
+
+void partition_csr(big_val_t& edge_cut,
+                const config_t& config,
+                big_ordinal_t n,
+                const big_offset_t* xadj,
+                const big_ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Device& exec,
+                context* ctx){
+
+    partitioner<biggest_matrix_t, part_t>::partition_csr(edge_cut, config, n, xadj, adjncy, adjwgt, vwgt, part, experiment, exec, context_workspace<biggest_matrix_t, part_t>(ctx));
+}
+
+void partition_host_csr(big_val_t& edge_cut,
+                const config_t& config,
+                big_ordinal_t n,
+                const big_offset_t* xadj,
+                const big_ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::DefaultHostExecutionSpace& exec,
+                context* ctx){
+
+    partitioner<biggest_host_matrix_t, part_t>::partition_csr(edge_cut, config, n, xadj, adjncy, adjwgt, vwgt, part, experiment, exec, context_workspace<biggest_host_matrix_t, part_t>(ctx));
+}
+
+void partition_serial_csr(big_val_t& edge_cut,
+                const config_t& config,
+                big_ordinal_t n,
+                const big_offset_t* xadj,
+                const big_ordinal_t* adjncy,
+                const big_val_t* adjwgt,
+                const big_val_t* vwgt,
+                part_t* part,
+                experiment_data<big_val_t>& experiment,
+                const Kokkos::Serial& exec,
+                context* ctx){
+
+    partitioner<biggest_serial_matrix_t, part_t>::partition_csr(edge_cut, config, n, xadj, adjncy, adjwgt, vwgt, part, experiment, exec, context_workspace<biggest_serial_matrix_t, part_t>(ctx));
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,200 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#include "jet_c.h"
+#include "jet.h"
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <type_traits>
+
+using namespace jet_partitioner;
+
+struct jet_context_s {
+    context data;
+};
+
+static_assert(std::is_same_v<part_t, int32_t>, "the C interface passes parts as int32_t");
+
+namespace {
+
+//set when jet_initialize started Kokkos, so that jet_finalize leaves an application's runtime alone
+bool owns_kokkos = false;
+
+//true if a caller's struct of options.struct_size bytes contains member
+#define JET_HAS_OPTION(options, member) ((options).struct_size >= offsetof(jet_options, member) + sizeof((options).member))
+
+//converts options to a config, starting from the defaults for fields the caller's struct does not have
+//returns false if the struct is too small or a value is outside the limits of config_t
+bool to_config(const jet_options& options, config_t& config){
+    if(!JET_HAS_OPTION(options, time_limit)) return false;
+    config.num_parts = options.num_parts;
+    config.max_imb_ratio = options.max_imb_ratio;
+    config.coarsening_alg = options.coarsening_alg;
+    config.refine_tolerance = options.refine_tolerance;
+    config.seed = options.seed;
+    config.ultra_settings = options.ultra_settings != 0;
+    config.verbose = options.verbose != 0;
+    if(options.time_limit > 0){
+        config.deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.time_limit));
+    }
+    if(JET_HAS_OPTION(options, coarse_vertices_per_part)) config.coarse_vertices_per_part = options.coarse_vertices_per_part;
+    if(JET_HAS_OPTION(options, coarse_cutoff)) config.coarse_cutoff = options.coarse_cutoff;
+    if(JET_HAS_OPTION(options, max_levels)) config.max_levels = options.max_levels;
+    if(JET_HAS_OPTION(options, lp_temp_uniform)) config.lp_temp_uniform = options.lp_temp_uniform;
+    if(JET_HAS_OPTION(options, lp_temp_weighted)) config.lp_temp_weighted = options.lp_temp_weighted;
+    if(JET_HAS_OPTION(options, ultra_temp_start)) config.ultra_temp_start = options.ultra_temp_start;
+    if(JET_HAS_OPTION(options, ultra_temp_step)) config.ultra_temp_step = options.ultra_temp_step;
+    if(JET_HAS_OPTION(options, refine_patience)) config.refine_patience = options.refine_patience;
+    if(JET_HAS_OPTION(options, max_buckets)) config.max_buckets = options.max_buckets;
+    if(JET_HAS_OPTION(options, max_sections)) config.max_sections = options.max_sections;
+    if(JET_HAS_OPTION(options, update_large_ratio)) config.update_large_ratio = options.update_large_ratio;
+    //the same limits as keyed config files
+    return config.num_parts > 0 && config.max_imb_ratio >= 1.0
+        && config.coarse_vertices_per_part > 0 && config.coarse_cutoff >= 0 && config.max_levels > 0
+        && config.lp_temp_uniform > 0 && config.lp_temp_uniform <= 1
+        && config.lp_temp_weighted > 0 && config.lp_temp_weighted <= 1
+        && config.ultra_temp_start > 0 && config.ultra_temp_start <= 1 && config.ultra_temp_step > 0
+        && config.refine_patience > 0 && config.max_buckets >= 4 && config.max_buckets <= 64
+        && config.max_sections > 0 && config.max_sections <= 4096 && config.update_large_ratio >= 0;
+}
+
+template<typename ordinal_type, typename offset_type, typename scalar_type>
+int partition_arrays(const jet_options* options, ordinal_type n, const offset_type* xadj, const ordinal_type* adjncy,
+    const scalar_type* adjwgt, const scalar_type* vwgt, int32_t* part, scalar_type* edge_cut, int32_t* truncated, jet_context ctx){
+
+    if(!Kokkos::is_initialized()) return JET_ERROR_NOT_INITIALIZED;
+    config_t config;
+    if(options == nullptr || !to_config(*options, config) || n < 0 || xadj == nullptr || (n > 0 && (adjncy == nullptr || part == nullptr))){
+        std::cerr << "FATAL ERROR: invalid arguments to the partitioner" << std::endl;
+        return JET_ERROR_INVALID_ARGUMENT;
+    }
+    experiment_data<scalar_type> experiment;
+    scalar_type cut = 0;
+    //exceptions must not cross the C boundary
+    try {
+        partition_host_csr(cut, config, n, xadj, adjncy, adjwgt, vwgt, part, experiment, Kokkos::DefaultHostExecutionSpace(), ctx != nullptr ? &ctx->data : nullptr);
+    } catch(const std::exception& e) {
+        std::cerr << "FATAL ERROR: " << e.what() << std::endl;
+        return JET_ERROR_INTERNAL;
+    }
+    if(edge_cut != nullptr) *edge_cut = cut;
+    if(truncated != nullptr) *truncated = experiment.isTruncated() ? 1 : 0;
+    return JET_OK;
+}
+
+}
+
+extern "C" {
+
+int jet_initialize(int32_t num_threads, int32_t device_id){
+    if(Kokkos::is_initialized()) return JET_OK;
+    Kokkos::InitializationSettings settings;
+    if(num_threads > 0) settings.set_num_threads(num_threads);
+    if(device_id >= 0) settings.set_device_id(device_id);
+    try {
+        Kokkos::initialize(settings);
+    } catch(const std::exception& e) {
+        std::cerr << "FATAL ERROR: " << e.what() << std::endl;
+        return JET_ERROR_INTERNAL;
+    }
+    owns_kokkos = true;
+    return JET_OK;
+}
+
+int jet_finalize(void){
+    if(owns_kokkos && Kokkos::is_initialized()) Kokkos::finalize();
+    owns_kokkos = false;
+    return JET_OK;
+}
+
+void jet_options_init(jet_options* options){
+    if(options == nullptr) return;
+    config_t config;
+    options->struct_size = sizeof(jet_options);
+    options->num_parts = config.num_parts;
+    options->max_imb_ratio = config.max_imb_ratio;
+    options->coarsening_alg = config.coarsening_alg;
+    options->refine_tolerance = config.refine_tolerance;
+    options->seed = config.seed;
+    options->ultra_settings = config.ultra_settings ? 1 : 0;
+    options->verbose = config.verbose ? 1 : 0;
+    options->time_limit = 0;
+    options->coarse_vertices_per_part = config.coarse_vertices_per_part;
+    options->coarse_cutoff = config.coarse_cutoff;
+    options->max_levels = config.max_levels;
+    options->lp_temp_uniform = config.lp_temp_uniform;
+    options->lp_temp_weighted = config.lp_temp_weighted;
+    options->ultra_temp_start = config.ultra_temp_start;
+    options->ultra_temp_step = config.ultra_temp_step;
+    options->refine_patience = config.refine_patience;
+    options->max_buckets = config.max_buckets;
+    options->max_sections = config.max_sections;
+    options->update_large_ratio = config.update_large_ratio;
+}
+
+int jet_context_create(jet_context* ctx){
+    if(ctx == nullptr) return JET_ERROR_INVALID_ARGUMENT;
+    if(!Kokkos::is_initialized()) return JET_ERROR_NOT_INITIALIZED;
+    *ctx = new jet_context_s();
+    return JET_OK;
+}
+
+void jet_context_destroy(jet_context ctx){
+    delete ctx;
+}
+
+int jet_partition(const jet_options* options, int32_t n, const int32_t* xadj, const int32_t* adjncy,
+    const int32_t* adjwgt, const int32_t* vwgt, int32_t* part, int32_t* edge_cut, int32_t* truncated, jet_context ctx){
+
+    return partition_arrays<ordinal_t, edge_offset_t, value_t>(options, n, xadj, adjncy, adjwgt, vwgt, part, edge_cut, truncated, ctx);
+}
+
+int jet_partition_big(const jet_options* options, int32_t n, const int64_t* xadj, const int32_t* adjncy,
+    const int64_t* adjwgt, const int64_t* vwgt, int32_t* part, int64_t* edge_cut, int32_t* truncated, jet_context ctx){
+
+    return partition_arrays<ordinal_t, big_offset_t, big_val_t>(options, n, xadj, adjncy, adjwgt, vwgt, part, edge_cut, truncated, ctx);
+}
+
+int jet_partition_biggest(const jet_options* options, int64_t n, const int64_t* xadj, const int64_t* adjncy,
+    const int64_t* adjwgt, const int64_t* vwgt, int32_t* part, int64_t* edge_cut, int32_t* truncated, jet_context ctx){
+
+    return partition_arrays<big_ordinal_t, big_offset_t, big_val_t>(options, n, xadj, adjncy, adjwgt, vwgt, part, edge_cut, truncated, ctx);
+}
+
+}
@@ -40,7 +40,9 @@
 #include <type_traits>
 #include <limits>
 #include <vector>
+#include <algorithm>
 #include <Kokkos_Core.hpp>
+#include <Kokkos_Sort.hpp>
 #include "KokkosSparse_CrsMatrix.hpp"
 #include "experiment_data.hpp"
 #include "part_stat.hpp"
@@ -69,6 +71,7 @@ public:
     // need some trickery because make_signed is undefined for floating point types
     using gain_t = typename std::conditional_t<std::is_signed_v<scalar_t>, type_identity<scalar_t>, std::make_signed<scalar_t>>::type;
     using vtx_vt = Kokkos::View<ordinal_t*, Device>;
+    using key_vt = Kokkos::View<uint64_t*, Device>;
     using vtx_pin_st = Kokkos::View<ordinal_t, Kokkos::SharedHostPinnedSpace>;
     using wgt_vt = Kokkos::View<scalar_t*, Device>;
     using edge_vt = Kokkos::View<edge_offset_t*, Device>;
@@ -88,9 +91,16 @@ public:
     static constexpr part_t HASH_RECLAIM = -2;
     static constexpr part_t NO_MOVE = -3;
 
-    static const ordinal_t max_sections = 128;
-    static const int max_buckets = 50;
-    static const int mid_bucket = 25;
+    //from this many parts on, evictions are ranked by sorting the candidates
+    //instead of counting them in buckets*k*sections minibuckets
+    static const part_t sorted_evict_k = 4096;
+    //sorted eviction keys hold the part in 26 bits and the candidate index in 32 bits
+    static constexpr part_t sorted_evict_part_limit = static_cast<part_t>(1) << 26;
+    static constexpr uint64_t sorted_evict_candidate_limit = static_cast<uint64_t>(1) << 32;
+    //sorted eviction keys hold the gain bucket in 6 bits
+    static const int bucket_limit = 64;
+    //keeps the minibucket grid of sorted_evict_k*bucket_limit*section_limit entries within 32-bit ordinals
+    static const int section_limit = 4096;
 
 //data that is preserved between levels in the multilevel scheme
 struct refine_data {
@@ -108,6 +118,9 @@ struct problem {
     double imb;
     ordinal_t opt;
     ordinal_t size_max;
+    int max_buckets;
+    ordinal_t max_sections;
+    double update_large_ratio;
 };
 
 //vertex-part connectivity data
@@ -118,18 +131,23 @@ struct conn_data {
     part_vt dest_cache;
     part_vt conn_entries;
     part_vt conn_table_sizes;
+    //largest conn table, bounds the team scratch of the high-degree kernels
+    part_t max_table_size = 0;
 };
 
 //this struct contains all the scratch memory used by the refinement iterations
 struct scratch_mem {
     gain_vt gain1, gain2, gain_persistent, evict_start, evict_end, evict_fix, evict_diff;
     vtx_vt vtx1, vtx2, zeros1;
-    part_vt dest_part, undersized;
+    part_vt dest_part, current_part, undersized;
     vtx_pin_st scan_host;
     gain_pin_st cut_change1, cut_change2, max_part;
     gain_pin_vt reduce_locs;
     part_svt total_undersized;
     gain_svt max_vwgt;
+    //only allocated for sorted evictions
+    key_vt evict_keys;
+    gain_vt evict_begin, evict_total;
 
     scratch_mem(const ordinal_t n, const ordinal_t min_size, const part_t k) {
         gain1 = gain_vt(Kokkos::ViewAllocateWithoutInitializing("gain scratch 1"), std::max(n, min_size));
@@ -142,6 +160,7 @@ struct scratch_mem {
         vtx1 = vtx_vt(Kokkos::ViewAllocateWithoutInitializing("vtx scratch 1"), n);
         vtx2 = vtx_vt(Kokkos::ViewAllocateWithoutInitializing("vtx scratch 2"), std::max(n, min_size));
         dest_part = part_vt(Kokkos::ViewAllocateWithoutInitializing("destination scratch"), n);
+        current_part = part_vt(Kokkos::ViewAllocateWithoutInitializing("current partition"), n);
         zeros1 = vtx_vt("zeros 1", n);
         scan_host = vtx_pin_st("scan host");
         total_undersized = part_svt("total undersized");
@@ -150,16 +169,28 @@ struct scratch_mem {
         cut_change1 = Kokkos::subview(reduce_locs, 0);
         cut_change2 = Kokkos::subview(reduce_locs, 1);
         max_part = Kokkos::subview(reduce_locs, 2);
+        if(sorted_evictions(k, n)){
+            evict_keys = key_vt(Kokkos::ViewAllocateWithoutInitializing("eviction keys"), n);
+            evict_begin = gain_vt(Kokkos::ViewAllocateWithoutInitializing("eviction begin"), k);
+            evict_total = gain_vt("eviction total", k);
+        }
     }
 };
 
+    //refinement kernels and fences only touch this instance
+    exec_space exec;
+    //sizes that perm_scratch and perm_cdata were allocated for
+    ordinal_t capacity_n;
+    edge_offset_t capacity_gain;
+    part_t capacity_k;
+    ordinal_t capacity_minibuckets;
     scratch_mem perm_scratch;
     conn_data perm_cdata;
 
     //find maximum size for conn_entries and conn_vals
-    edge_offset_t count_gain_size(const matrix_t largest, part_t k){
+    static edge_offset_t count_gain_size(const matrix_t largest, part_t k, const exec_space& exec){
         edge_offset_t gain_size = 0;
-        Kokkos::parallel_reduce("comp offsets", policy_t(0, largest.numRows()), KOKKOS_LAMBDA(const ordinal_t& i, edge_offset_t& update){
+        Kokkos::parallel_reduce("comp offsets", policy_t(exec, 0, largest.numRows()), KOKKOS_LAMBDA(const ordinal_t& i, edge_offset_t& update){
             ordinal_t degree = largest.graph.row_map(i + 1) - largest.graph.row_map(i);
             if(degree > static_cast<ordinal_t>(k)) degree = k;
             update += degree;
@@ -167,11 +198,33 @@ struct scratch_mem {
         return gain_size;
     }
 
-    jet_refiner(const matrix_t largest, part_t k) :
-        perm_scratch(largest.numRows(), k*max_sections*max_buckets, k) {
-        ordinal_t n = largest.numRows();
+    //gain buckets used for rebalancing
+    static int gain_buckets(const config_t& config){
+        return std::clamp(config.max_buckets, 4, static_cast<int>(bucket_limit));
+    }
+
+    static ordinal_t gain_sections(const config_t& config){
+        return std::clamp(config.max_sections, 1, static_cast<int>(section_limit));
+    }
+
+    //size of the minibucket grid used for rebalancing into k parts
+    static ordinal_t minibucket_count(const config_t& config, part_t k, ordinal_t n){
+        return sorted_evictions(k, n) ? 0 : k*gain_sections(config)*gain_buckets(config);
+    }
+
+    jet_refiner(const matrix_t largest, const config_t& config, const exec_space& _exec = exec_space()) :
+        jet_refiner(largest.numRows(), count_gain_size(largest, config.num_parts, _exec), config.num_parts, minibucket_count(config, config.num_parts, largest.numRows()), _exec) {}
+
+    //allocates scratch memory for refining graphs with up to n vertices and gain_size connectivity entries into k parts
+    //with a minibucket grid of the given size
+    jet_refiner(ordinal_t n, edge_offset_t gain_size, part_t k, ordinal_t minibuckets, const exec_space& _exec) :
+        exec(_exec),
+        capacity_n(n),
+        capacity_gain(gain_size),
+        capacity_k(k),
+        capacity_minibuckets(minibuckets),
+        perm_scratch(n, minibuckets, k) {
         edge_vt conn_offsets("gain offsets", n + 1);
-        edge_offset_t gain_size = count_gain_size(largest, k);
         perm_cdata.conn_vals = gain_vt(Kokkos::ViewAllocateWithoutInitializing("conn vals"), gain_size);
         perm_cdata.conn_entries = part_vt(Kokkos::ViewAllocateWithoutInitializing("conn entries"), gain_size);
         perm_cdata.conn_offsets = conn_offsets;
@@ -180,8 +233,22 @@ struct scratch_mem {
         perm_cdata.lock_bit = vtx_vt("lock bit", n);
     }
 
+    //true if the scratch memory is large enough to refine every level of a hierarchy whose finest graph is largest
+    bool fits(const matrix_t largest, const config_t& config) const {
+        part_t k = config.num_parts;
+        return k == capacity_k && minibucket_count(config, k, capacity_n) <= capacity_minibuckets
+            && largest.numRows() <= capacity_n && count_gain_size(largest, k, exec) <= capacity_gain;
+    }
+
+    //the minibucket grid grows with k, sorting grows with the number of eviction candidates
+    //graphs with too many vertices or parts for the sort keys fall back to the minibuckets
+    //n is the vertex capacity of the scratch memory, so every level of a hierarchy uses the same method
+    static bool sorted_evictions(part_t k, ordinal_t n){
+        return k >= sorted_evict_k && k < sorted_evict_part_limit && static_cast<uint64_t>(n) <= sorted_evict_candidate_limit;
+    }
+
 void copy_refine_data(refine_data& lhs, refine_data& rhs){
-    Kokkos::deep_copy(exec_space(), lhs.part_sizes, rhs.part_sizes);
+    Kokkos::deep_copy(exec, lhs.part_sizes, rhs.part_sizes);
     lhs.total_size = rhs.total_size;
     lhs.cut = rhs.cut;
     lhs.total_imb = rhs.total_imb;
@@ -208,7 +275,7 @@ vtx_vt jet_lp(const problem& prob, const part_vt& part, const conn_data& cdata,
     gain_vt conn_vals = cdata.conn_vals;
     gain_vt save_gains = scratch.gain_persistent;
     vtx_vt lock_bit = cdata.lock_bit;
-    Kokkos::parallel_for("select destination part (lp)", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i){
+    Kokkos::parallel_for("select destination part (lp)", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i){
         part_t best = cdata.dest_cache(i);
         if(best != NULL_PART) {
             dest_part(i) = best;
@@ -252,7 +319,7 @@ vtx_vt jet_lp(const problem& prob, const part_vt& part, const conn_data& cdata,
     gain_vt pregain = scratch.gain1;
     //write all unlocked vertices that passed the above filter into an unordered list
     //output count of such vertices into num_pos
-    Kokkos::parallel_scan("filter potentially viable moves", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
+    Kokkos::parallel_scan("filter potentially viable moves", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
         if(dest_part(i) != NO_MOVE && lock_bit(i) == 0){
             if(final){
                 swap_scratch(update) = i;
@@ -264,7 +331,7 @@ vtx_vt jet_lp(const problem& prob, const part_vt& part, const conn_data& cdata,
             lock_bit(i) = 0;
         }
     }, scratch.scan_host);
-    exec_space().fence();
+    exec.fence();
     num_pos = scratch.scan_host();
     //truncate scratch views by num_pos
     vtx_vt pos_moves = Kokkos::subview(swap_scratch, std::make_pair(static_cast<ordinal_t>(0), num_pos));
@@ -272,7 +339,7 @@ vtx_vt jet_lp(const problem& prob, const part_vt& part, const conn_data& cdata,
     //is reevaluated by considering the effect of the other potential moves
     //a move is considered to occur before another according to their potential gains
     //and the vertex ids
-    Kokkos::parallel_for("afterburner heuristic", team_policy_t(num_pos, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
+    Kokkos::parallel_for("afterburner heuristic", team_policy_t(exec, num_pos, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
         gain_t change = 0;
         ordinal_t i = pos_moves(t.league_rank());
         part_t best = dest_part(i);
@@ -307,7 +374,7 @@ vtx_vt jet_lp(const problem& prob, const part_vt& part, const conn_data& cdata,
     });
     vtx_vt swaps2 = Kokkos::subview(scratch.vtx2, std::make_pair(static_cast<ordinal_t>(0), num_pos));
     //scan all vertices that passed the post filter
-    Kokkos::parallel_scan("filter beneficial moves", policy_t(0, num_pos), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
+    Kokkos::parallel_scan("filter beneficial moves", policy_t(exec, 0, num_pos), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
         ordinal_t v = pos_moves(i);
         if(lock_bit(v)){
             if(final){
@@ -316,14 +383,14 @@ vtx_vt jet_lp(const problem& prob, const part_vt& part, const conn_data& cdata,
             update++;
         }
     }, scratch.scan_host);
-    exec_space().fence();
+    exec.fence();
     num_pos = scratch.scan_host();
     pos_moves = Kokkos::subview(swaps2, std::make_pair(static_cast<ordinal_t>(0), num_pos));
     return pos_moves;
 }
 
 KOKKOS_INLINE_FUNCTION
-static ordinal_t gain_bucket(const gain_t& gx, const scalar_t& vwgt){
+static ordinal_t gain_bucket(const gain_t& gx, const scalar_t& vwgt, const int buckets){
     //cast to float so we can approximate log_1.5
     float gain = static_cast<float>(gx) / static_cast<float>(vwgt);
     ordinal_t gain_type = 0;
@@ -332,7 +399,7 @@ static ordinal_t gain_bucket(const gain_t& gx, const scalar_t& vwgt){
     } else if(gain == 0.0) {
         gain_type = 1;
     } else {
-        gain_type = mid_bucket;
+        gain_type = buckets / 2;
         gain = abs(gain);
         if(gain < 1.0){
             while(gain < 1.0){
@@ -347,8 +414,8 @@ static ordinal_t gain_bucket(const gain_t& gx, const scalar_t& vwgt){
                 gain /= 1.5;
                 gain_type++;
             }
-            if(gain_type > max_buckets){
-                gain_type = max_buckets - 1;
+            if(gain_type >= buckets){
+                gain_type = buckets - 1;
             }
         }
     }
@@ -362,7 +429,7 @@ vtx_vt get_evictions(const problem& prob, const part_vt& part, scratch_mem& scra
     //exclusive prefix sum to compute offsets
     //bucket_sizes is an alias of bucket_offsets
     if(t_minibuckets < 10000 && !is_host_space){
-        Kokkos::parallel_for("scan score buckets", team_policy_t(1, 1024), KOKKOS_LAMBDA(const member& t){
+        Kokkos::parallel_for("scan score buckets", team_policy_t(exec, 1, 1024), KOKKOS_LAMBDA(const member& t){
             //this scan is small so do it within a team instead of an entire grid to save kernel launch time
             Kokkos::parallel_scan(Kokkos::TeamThreadRange(t, 0, t_minibuckets + 1), [&] (const ordinal_t i, gain_t& update, const bool final) {
                 gain_t x = bucket_sizes(i);
@@ -373,7 +440,7 @@ vtx_vt get_evictions(const problem& prob, const part_vt& part, scratch_mem& scra
             });
         });
     } else {
-        Kokkos::parallel_scan("scan score buckets", policy_t(0, t_minibuckets + 1), KOKKOS_LAMBDA(const ordinal_t& i, gain_t& update, const bool final){
+        Kokkos::parallel_scan("scan score buckets", policy_t(exec, 0, t_minibuckets + 1), KOKKOS_LAMBDA(const ordinal_t& i, gain_t& update, const bool final){
             gain_t x = bucket_sizes(i);
             if(final){
                 bucket_offsets(i) = update;
@@ -386,8 +453,8 @@ vtx_vt get_evictions(const problem& prob, const part_vt& part, scratch_mem& scra
     gain_vt save_atomic = scratch.gain2;
     vtx_vt bid = scratch.vtx2;
     gain_vt evict_adjust = scratch.evict_end;
-    if(adjust) Kokkos::deep_copy(exec_space(), evict_adjust, 0);
-    Kokkos::parallel_scan("filter scores below cutoff", policy_t(0, prob.g.numRows()), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
+    if(adjust) Kokkos::deep_copy(exec, evict_adjust, 0);
+    Kokkos::parallel_scan("filter scores below cutoff", policy_t(exec, 0, prob.g.numRows()), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
         ordinal_t b = bid(i);
         if(b != -1){
             part_t p = part(i);
@@ -405,7 +472,77 @@ vtx_vt get_evictions(const problem& prob, const part_vt& part, scratch_mem& scra
             }
         }
     }, scratch.scan_host);
-    exec_space().fence();
+    exec.fence();
+    ordinal_t num_moves = scratch.scan_host();
+    vtx_vt only_moves = Kokkos::subview(moves, std::make_pair(static_cast<ordinal_t>(0), num_moves));
+    return only_moves;
+}
+
+//replaces the minibuckets and get_evictions for large k, memory and work grow with the number of candidates
+//bid holds the gain bucket of each candidate or -1, candidates are sorted by part and then by gain bucket
+//the score of a candidate is the weight of the candidates ahead of it in its part, as with the minibuckets
+//evict_total receives the candidate weight of each part
+//keys pack part, gain bucket and candidate index, sorted_evictions ensures there are fewer than 2^26 parts and at most 2^32 candidates
+template <bool adjust>
+vtx_vt get_sorted_evictions(const problem& prob, const part_vt& part, scratch_mem& scratch, gain_vt part_sizes, const gain_t size_max){
+    const wgt_vt& vtx_w = prob.vtx_w;
+    vtx_vt bid = scratch.vtx2;
+    vtx_vt candidates = scratch.vtx1;
+    gain_vt score = scratch.gain2;
+    gain_vt evict_begin = scratch.evict_begin;
+    gain_vt evict_total = scratch.evict_total;
+    key_vt keys = scratch.evict_keys;
+    Kokkos::deep_copy(exec, evict_total, 0);
+    Kokkos::parallel_scan("collect eviction candidates", policy_t(exec, 0, prob.g.numRows()), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
+        ordinal_t b = bid(i);
+        if(b != -1){
+            if(final){
+                candidates(update) = i;
+                keys(update) = (static_cast<uint64_t>(part(i)) << 38) | (static_cast<uint64_t>(b) << 32) | static_cast<uint64_t>(update);
+            }
+            update++;
+        }
+    }, scratch.scan_host);
+    exec.fence();
+    ordinal_t num_candidates = scratch.scan_host();
+    key_vt sorted = Kokkos::subview(keys, std::make_pair(static_cast<ordinal_t>(0), num_candidates));
+    if(num_candidates > 1) Kokkos::sort(exec, sorted);
+    //segmented exclusive scan of candidate weights, segments are the parts
+    Kokkos::parallel_scan("scan sorted candidates", policy_t(exec, 0, num_candidates), KOKKOS_LAMBDA(const ordinal_t j, gain_t& update, const bool final){
+        ordinal_t v = candidates(sorted(j) & 0xffffffff);
+        if(final){
+            part_t p = part(v);
+            score(v) = update;
+            if(j == 0 || (sorted(j - 1) >> 38) != (sorted(j) >> 38)) evict_begin(p) = update;
+            if(j + 1 == num_candidates || (sorted(j + 1) >> 38) != (sorted(j) >> 38)) evict_total(p) = update + vtx_w(v);
+        }
+        update += vtx_w(v);
+    });
+    Kokkos::parallel_for("localize sorted scores", policy_t(exec, 0, num_candidates), KOKKOS_LAMBDA(const ordinal_t j){
+        ordinal_t v = candidates(sorted(j) & 0xffffffff);
+        part_t p = part(v);
+        score(v) -= evict_begin(p);
+        if(j == 0 || (sorted(j - 1) >> 38) != (sorted(j) >> 38)) evict_total(p) -= evict_begin(p);
+    });
+    vtx_vt moves = scratch.vtx1;
+    gain_vt evict_adjust = scratch.evict_end;
+    if(adjust) Kokkos::deep_copy(exec, evict_adjust, 0);
+    Kokkos::parallel_scan("filter sorted scores below cutoff", policy_t(exec, 0, prob.g.numRows()), KOKKOS_LAMBDA(const ordinal_t i, ordinal_t& update, const bool final){
+        if(bid(i) != -1){
+            part_t p = part(i);
+            gain_t limit = part_sizes(p) - size_max;
+            if(score(i) < limit){
+                if(final){
+                    if(adjust && score(i) + vtx_w(i) >= limit){
+                        evict_adjust(p) = score(i) + vtx_w(i);
+                    }
+                    moves(update) = i;
+                }
+                update++;
+            }
+        }
+    }, scratch.scan_host);
+    exec.fence();
     ordinal_t num_moves = scratch.scan_host();
     vtx_vt only_moves = Kokkos::subview(moves, std::make_pair(static_cast<ordinal_t>(0), num_moves));
     return only_moves;
@@ -420,7 +557,9 @@ vtx_vt rebalance_strong(const problem& prob, const part_vt& part, const conn_dat
     const gain_t opt_size = prob.opt;
     const wgt_vt& vtx_w = prob.vtx_w;
     ordinal_t n = g.numRows();
-    ordinal_t sections = max_sections;
+    const bool sorted = sorted_evictions(k, capacity_n);
+    const int buckets = prob.max_buckets;
+    ordinal_t sections = prob.max_sections;
     ordinal_t section_size = (n + sections*k) / (sections*k);
     if(section_size < 4096){
         section_size = 4096;
@@ -428,16 +567,16 @@ vtx_vt rebalance_strong(const problem& prob, const part_vt& part, const conn_dat
     }
     //use minibuckets within each gain bucket to reduce atomic contention
     //because the number of gain buckets is small
-    ordinal_t t_minibuckets = max_buckets*k*sections;
+    ordinal_t t_minibuckets = sorted ? 0 : buckets*k*sections;
     gain_vt bucket_sizes = Kokkos::subview(scratch.gain1, std::make_pair(static_cast<ordinal_t>(0), t_minibuckets + 1));
-    Kokkos::deep_copy(exec_space(), bucket_sizes, 0);
+    Kokkos::deep_copy(exec, bucket_sizes, 0);
     //atomically count vertices in each gain bucket
     gain_t size_max = prob.size_max;
     gain_t max_dest = std::max(opt_size + 1, static_cast<gain_t>(prob.size_max * 0.99));
     gain_vt save_atomic = scratch.gain2;
     vtx_vt bid = scratch.vtx2;
     gain_svt max_vwgt = scratch.max_vwgt;
-    Kokkos::parallel_reduce("find max size", policy_t(0, k), KOKKOS_LAMBDA(const part_t p, gain_t& update){
+    Kokkos::parallel_reduce("find max size", policy_t(exec, 0, k), KOKKOS_LAMBDA(const part_t p, gain_t& update){
         gain_t size = part_sizes(p);
         if(size < max_dest){
             gain_t cap = max_dest - size;
@@ -446,7 +585,7 @@ vtx_vt rebalance_strong(const problem& prob, const part_vt& part, const conn_dat
             }
         }
     }, Kokkos::Max<gain_t, mem_space>(max_vwgt));
-    Kokkos::parallel_for("assign move scores part1", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i){
+    Kokkos::parallel_for("assign move scores part1", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i){
         part_t p = part(i);
         bid(i) = -1;
         if(part_sizes(p) > size_max && vtx_w(i) <= 2*max_vwgt() && vtx_w(i) < 2*(part_sizes(p) - opt_size)){
@@ -470,17 +609,25 @@ vtx_vt rebalance_strong(const problem& prob, const part_vt& part, const conn_dat
             }
             if(tk == 0) tk = 1;
             gain_t gain = (tg / tk) - p_gain;
-            ordinal_t gain_type = gain_bucket(gain, Kokkos::min(vtx_w(i), part_sizes(p) - size_max));
+            ordinal_t gain_type = gain_bucket(gain, Kokkos::min(vtx_w(i), part_sizes(p) - size_max), buckets);
             //add to count of appropriate bucket
-            if(gain_type < max_buckets){
-                ordinal_t g_id = (max_buckets*p + gain_type) * sections + (i % sections) + 1;
+            if(gain_type < buckets && sorted){
+                bid(i) = gain_type;
+            } else if(gain_type < buckets){
+                ordinal_t g_id = (buckets*p + gain_type) * sections + (i % sections) + 1;
                 bid(i) = g_id;
                 save_atomic(i) = Kokkos::atomic_fetch_add(&bucket_sizes(g_id), vtx_w(i));
             }
         }
     });
     gain_vt bucket_offsets = bucket_sizes;
-    vtx_vt only_moves = get_evictions<true>(prob, part, scratch, part_sizes, t_minibuckets, max_buckets*sections, size_max);
+    gain_vt evict_total = scratch.evict_total;
+    vtx_vt only_moves;
+    if(sorted){
+        only_moves = get_sorted_evictions<true>(prob, part, scratch, part_sizes, size_max);
+    } else {
+        only_moves = get_evictions<true>(prob, part, scratch, part_sizes, t_minibuckets, buckets*sections, size_max);
+    }
     ordinal_t num_moves = only_moves.extent(0);
 
     // the rest of this method determines the destination part for each evicted vtx
@@ -488,16 +635,17 @@ vtx_vt rebalance_strong(const problem& prob, const part_vt& part, const conn_dat
     gain_vt evict_adjust = scratch.evict_end;
     part_vt dest_part = scratch.dest_part;
     //assign consecutive chunks of vertices to undersized parts using scan result
-    Kokkos::parallel_for("cookie cutter", team_policy_t(1, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
+    Kokkos::parallel_for("cookie cutter", team_policy_t(exec, 1, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
         Kokkos::parallel_scan(Kokkos::TeamThreadRange(t, 0, k), [&] (const part_t p, gain_t& update, const bool final) {
             gain_t add = evict_adjust(p);
-            ordinal_t begin_bucket = max_buckets*p*sections;
+            ordinal_t begin_bucket = buckets*p*sections;
             if(add == 0){
                 // evict_adjust(p) isn't set if there aren't enough evictions to balance part p
-                add = bucket_offsets(begin_bucket + max_buckets*sections) - bucket_offsets(begin_bucket);
+                add = sorted ? evict_total(p) : bucket_offsets(begin_bucket + buckets*sections) - bucket_offsets(begin_bucket);
             }
             if(final){
-                evict_adjust(p) = bucket_offsets(begin_bucket) - update;
+                //sorted scores are already relative to the start of their part
+                evict_adjust(p) = (sorted ? 0 : bucket_offsets(begin_bucket)) - update;
             }
             update += add;
             if(final && p+1 == k){
@@ -516,20 +664,27 @@ vtx_vt rebalance_strong(const problem& prob, const part_vt& part, const conn_dat
             }
         });
     });
-    Kokkos::parallel_for("adjust scores", policy_t(0, num_moves), KOKKOS_LAMBDA(const ordinal_t x){
+    Kokkos::parallel_for("adjust scores", policy_t(exec, 0, num_moves), KOKKOS_LAMBDA(const ordinal_t x){
         ordinal_t v = only_moves(x);
         part_t p = part(v);
-        ordinal_t b = bid(v);
-        gain_t score = save_atomic(v) + bucket_offsets(b) - evict_adjust(p);
+        gain_t score = save_atomic(v) - evict_adjust(p);
+        if(!sorted) score += bucket_offsets(bid(v));
         save_atomic(v) = score;
     });
-    Kokkos::parallel_for("select destination parts (rs)", policy_t(0, num_moves), KOKKOS_LAMBDA(const ordinal_t i){
+    Kokkos::parallel_for("select destination parts (rs)", policy_t(exec, 0, num_moves), KOKKOS_LAMBDA(const ordinal_t i){
         int p = 0;
         ordinal_t v = only_moves(i);
         while(p < k){
             //find chunk that contains i
-            while(p <= k && evict_start(p) <= save_atomic(v)){
-                p++;
+            //evict_start is nondecreasing, so binary search for the last chunk starting at or before the score
+            part_t hi = k + 1;
+            while(p < hi){
+                part_t mid = p + (hi - p) / 2;
+                if(evict_start(mid) <= save_atomic(v)){
+                    p = mid + 1;
+                } else {
+                    hi = mid;
+                }
             }
             p--;
             if(p < k && vtx_w(v)/2 <= evict_start(p+1) - save_atomic(v)){
@@ -554,7 +709,9 @@ vtx_vt rebalance_weak(const problem& prob, const part_vt& part, const conn_data&
     const gain_t opt_size = prob.opt;
     const wgt_vt& vtx_w = prob.vtx_w;
     ordinal_t n = g.numRows();
-    ordinal_t sections = max_sections;
+    const bool sorted = sorted_evictions(k, capacity_n);
+    const int buckets = prob.max_buckets;
+    ordinal_t sections = prob.max_sections;
     ordinal_t section_size = (n + sections*k) / (sections*k);
     if(section_size < 4096){
         section_size = 4096;
@@ -562,10 +719,10 @@ vtx_vt rebalance_weak(const problem& prob, const part_vt& part, const conn_data&
     }
     //use minibuckets within each gain bucket to reduce atomic contention
     //because the number of gain buckets is small
-    ordinal_t t_minibuckets = max_buckets*k*sections;
+    ordinal_t t_minibuckets = sorted ? 0 : buckets*k*sections;
     gain_vt bucket_offsets = Kokkos::subview(scratch.gain1, std::make_pair(static_cast<ordinal_t>(0), t_minibuckets + 1));
     gain_vt bucket_sizes = bucket_offsets;
-    Kokkos::deep_copy(exec_space(), bucket_sizes, 0);
+    Kokkos::deep_copy(exec, bucket_sizes, 0);
     part_vt dest_part = scratch.dest_part;
     gain_t size_max = prob.size_max;
     gain_vt save_gains = scratch.gain2;
@@ -575,7 +732,7 @@ vtx_vt rebalance_weak(const problem& prob, const part_vt& part, const conn_data&
         max_dest = size_max - 100;
     }
     part_svt total_undersized = scratch.total_undersized;
-    Kokkos::parallel_for("init undersized parts list", team_policy_t(1, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
+    Kokkos::parallel_for("init undersized parts list", team_policy_t(exec, 1, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
         //this scan is small so do it within a team instead of an entire grid to save kernel launch time
         Kokkos::parallel_scan(Kokkos::TeamThreadRange(t, 0, k), [&] (const part_t i, part_t& update, const bool final) {
             if(part_sizes(i) < max_dest){
@@ -589,7 +746,7 @@ vtx_vt rebalance_weak(const problem& prob, const part_vt& part, const conn_data&
             }
         });
     });
-    Kokkos::parallel_for("select destination parts (rw)", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i) {
+    Kokkos::parallel_for("select destination parts (rw)", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i) {
         part_t p = part(i);
         gain_t p_gain = 0;
         part_t best = p;
@@ -629,19 +786,26 @@ vtx_vt rebalance_weak(const problem& prob, const part_vt& part, const conn_data&
     vtx_vt bid = scratch.vtx2;
     //atomically add vwgts in each gain bucket
     //use atomic_fetch_add to get score
-    Kokkos::parallel_for("assign move scores", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t i){
+    Kokkos::parallel_for("assign move scores", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t i){
         part_t p = part(i);
         part_t best = dest_part(i);
         bid(i) = -1;
         if(p != best){
             gain_t gain = save_gains(i);
-            ordinal_t gain_type = gain_bucket(gain, vtx_w(i));
-            ordinal_t g_id = (max_buckets*p + gain_type) * sections + (i % sections);
-            bid(i) = g_id;
-            vscore(i) = Kokkos::atomic_fetch_add(&bucket_sizes(g_id), vtx_w(i));
+            ordinal_t gain_type = gain_bucket(gain, vtx_w(i), buckets);
+            if(sorted){
+                bid(i) = gain_type;
+            } else {
+                ordinal_t g_id = (buckets*p + gain_type) * sections + (i % sections);
+                bid(i) = g_id;
+                vscore(i) = Kokkos::atomic_fetch_add(&bucket_sizes(g_id), vtx_w(i));
+            }
         }
     });
-    return get_evictions<false>(prob, part, scratch, part_sizes, t_minibuckets, max_buckets*sections, size_max);
+    if(sorted){
+        return get_sorted_evictions<false>(prob, part, scratch, part_sizes, size_max);
+    }
+    return get_evictions<false>(prob, part, scratch, part_sizes, t_minibuckets, buckets*sections, size_max);
 }
 
 KOKKOS_INLINE_FUNCTION
@@ -745,7 +909,9 @@ void update_large(const problem& prob, part_vt part, const vtx_vt swaps, scratch
     const part_t k = prob.k;
     ordinal_t total_moves = swaps.extent(0);
     vtx_vt swap_bit = scratch.zeros1;
-    Kokkos::parallel_for("mark adjacent", team_policy_t(total_moves, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
+    //a conn table has at most min(degree, k) entries, which is much less than k when k is large
+    size_t table_bytes = cdata.max_table_size*(sizeof(gain_t) + sizeof(part_t)) + 4*sizeof(part_t);
+    Kokkos::parallel_for("mark adjacent", team_policy_t(exec, total_moves, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
         ordinal_t i = swaps(t.league_rank());
         //mark adjacent vertices
         Kokkos::parallel_for(Kokkos::TeamThreadRange(t, g.graph.row_map(i), g.graph.row_map(i + 1)), [=] (const edge_offset_t j){
@@ -754,7 +920,7 @@ void update_large(const problem& prob, part_vt part, const vtx_vt swaps, scratch
         });
     });
     //recompute conn tables for each vertex adjacent to a moved vertex
-    Kokkos::parallel_for("reset conn DS", team_policy_t(g.numRows(), Kokkos::AUTO).set_scratch_size(0, Kokkos::PerTeam(k*sizeof(gain_t) + k*sizeof(part_t) + 4*sizeof(part_t))), KOKKOS_LAMBDA(const member& t){
+    Kokkos::parallel_for("reset conn DS", team_policy_t(exec, g.numRows(), Kokkos::AUTO).set_scratch_size(0, Kokkos::PerTeam(table_bytes)), KOKKOS_LAMBDA(const member& t){
         ordinal_t i = t.league_rank();
         if(swap_bit(i) == 1){
             edge_offset_t g_start = cdata.conn_offsets(i);
@@ -782,7 +948,7 @@ void update_small(const problem& prob, const part_vt part, const vtx_vt swaps, c
     const matrix_t& g = prob.g;
     const part_t k = prob.k;
     ordinal_t total_moves = swaps.extent(0);
-    Kokkos::parallel_for("update conns (subtract) (high degree)", team_policy_t(total_moves, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
+    Kokkos::parallel_for("update conns (subtract) (high degree)", team_policy_t(exec, total_moves, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
         ordinal_t i = swaps(t.league_rank());
         //dest_part stores old part at this point
         part_t p = dest_part(i);
@@ -806,7 +972,7 @@ void update_small(const problem& prob, const part_vt part, const vtx_vt swaps, c
             }
         });
     });
-    Kokkos::parallel_for("update conns (add) (high degree)", team_policy_t(total_moves, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
+    Kokkos::parallel_for("update conns (add) (high degree)", team_policy_t(exec, total_moves, Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
         ordinal_t i = swaps(t.league_rank());
         //part contains new part at this point
         part_t best = part(i);
@@ -907,7 +1073,7 @@ void perform_moves(const problem& prob, part_vt part, const vtx_vt swaps, const
     const wgt_vt& vtx_w = prob.vtx_w;
     ordinal_t total_moves = swaps.extent(0);
     //total change in cutsize = (sum over all moves) -((new_b_con - new_p_con) + (old_b_con - old_p_con))
-    Kokkos::parallel_reduce("count cutsize change part1", policy_t(0, total_moves), KOKKOS_LAMBDA(const ordinal_t& x, gain_t& gain_update){
+    Kokkos::parallel_reduce("count cutsize change part1", policy_t(exec, 0, total_moves), KOKKOS_LAMBDA(const ordinal_t& x, gain_t& gain_update){
         ordinal_t i = swaps(x);
         part_t best = dest_part(i);
         part_t p = part(i);
@@ -918,7 +1084,7 @@ void perform_moves(const problem& prob, part_vt part, const vtx_vt swaps, const
         gain_update += b_con - p_con;
     }, scratch.cut_change1);
     //change part assignments and update part sizes
-    Kokkos::parallel_for("perform moves", policy_t(0, total_moves), KOKKOS_LAMBDA(const ordinal_t x){
+    Kokkos::parallel_for("perform moves", policy_t(exec, 0, total_moves), KOKKOS_LAMBDA(const ordinal_t x){
         ordinal_t i = swaps(x);
         part_t p = part(i);
         part_t best = dest_part(i);
@@ -929,12 +1095,12 @@ void perform_moves(const problem& prob, part_vt part, const vtx_vt swaps, const
         //update needs to know old part assignment
         dest_part(i) = p;
     });
-    if(total_moves > static_cast<ordinal_t>(g.numRows() / 10)){
+    if(total_moves > static_cast<ordinal_t>(g.numRows() * prob.update_large_ratio)){
         update_large(prob, part, swaps, scratch, cdata);
     } else {
         update_small(prob, part, swaps, dest_part, cdata);
     }
-    Kokkos::parallel_reduce("count cutsize change part2", policy_t(0, total_moves), KOKKOS_LAMBDA(const ordinal_t& x, gain_t& gain_update){
+    Kokkos::parallel_reduce("count cutsize change part2", policy_t(exec, 0, total_moves), KOKKOS_LAMBDA(const ordinal_t& x, gain_t& gain_update){
         ordinal_t i = swaps(x);
         part_t p = dest_part(i);
         part_t best = part(i);
@@ -944,8 +1110,8 @@ void perform_moves(const problem& prob, part_vt part, const vtx_vt swaps, const
         gain_t b_con = lookup(cdata.conn_entries.data() + start, cdata.conn_vals.data() + start, best, size);
         gain_update += b_con - p_con;
     }, scratch.cut_change2);
-    stat::stash_largest(curr_state.part_sizes, scratch.max_part);
-    exec_space().fence();
+    stat::stash_largest(curr_state.part_sizes, scratch.max_part, exec);
+    exec.fence();
     //this whole mess avoids 2 stream-syncs on the 3 reductions in this function
     //by combining their data movements to host together
     int64_t cut_change = scratch.cut_change2() + scratch.cut_change1();
@@ -959,13 +1125,16 @@ conn_data init_conn_data(const conn_data& scratch_cdata, const matrix_t& g, cons
     ordinal_t n = g.numRows();
     conn_data cdata;
     cdata.conn_offsets = Kokkos::subview(scratch_cdata.conn_offsets, std::make_pair(static_cast<ordinal_t>(0), n + 1));
-    Kokkos::parallel_for("comp conn row size", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t& i){
+    part_t max_table_size = 0;
+    Kokkos::parallel_reduce("comp conn row size", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t& i, part_t& update){
         ordinal_t degree = g.graph.row_map(i + 1) - g.graph.row_map(i);
         if(degree > static_cast<ordinal_t>(k)) degree = k;
         cdata.conn_offsets(i + 1) = degree;
-    });
+        if(degree > update) update = degree;
+    }, Kokkos::Max<part_t>(max_table_size));
+    cdata.max_table_size = max_table_size;
     edge_offset_t gain_size = 0;
-    Kokkos::parallel_scan("comp conn offsets", policy_t(0, n + 1), KOKKOS_LAMBDA(const ordinal_t& i, edge_offset_t& update, const bool final){
+    Kokkos::parallel_scan("comp conn offsets", policy_t(exec, 0, n + 1), KOKKOS_LAMBDA(const ordinal_t& i, edge_offset_t& update, const bool final){
         update += cdata.conn_offsets(i);
         if(final){
             cdata.conn_offsets(i) = update;
@@ -976,15 +1145,15 @@ conn_data init_conn_data(const conn_data& scratch_cdata, const matrix_t& g, cons
     cdata.dest_cache = Kokkos::subview(scratch_cdata.dest_cache, std::make_pair(static_cast<ordinal_t>(0), n));
     cdata.conn_table_sizes = Kokkos::subview(scratch_cdata.conn_table_sizes, std::make_pair(static_cast<ordinal_t>(0), n));
     cdata.lock_bit = Kokkos::subview(scratch_cdata.lock_bit, std::make_pair(static_cast<ordinal_t>(0), n));
-    Kokkos::deep_copy(exec_space(), cdata.conn_vals, 0);
-    Kokkos::deep_copy(exec_space(), cdata.conn_entries, NULL_PART);
-    Kokkos::deep_copy(exec_space(), cdata.dest_cache, NULL_PART);
-    Kokkos::deep_copy(exec_space(), cdata.lock_bit, 0);
+    Kokkos::deep_copy(exec, cdata.conn_vals, 0);
+    Kokkos::deep_copy(exec, cdata.conn_entries, NULL_PART);
+    Kokkos::deep_copy(exec, cdata.dest_cache, NULL_PART);
+    Kokkos::deep_copy(exec, cdata.lock_bit, 0);
     //initialize conn tables for each vertex
     //conn tables are resized to be small so that traversal is faster, but large enough so that updates have few collisions
     if((g.nnz() / g.numRows()) < 8) {
         //low degree version
-        Kokkos::parallel_for("init conn DS", policy_t(0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t& i){
+        Kokkos::parallel_for("init conn DS", policy_t(exec, 0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t& i){
             edge_offset_t g_start = cdata.conn_offsets(i);
             edge_offset_t g_end = cdata.conn_offsets(i + 1);
             part_t size = g_end - g_start;
@@ -1040,7 +1209,8 @@ conn_data init_conn_data(const conn_data& scratch_cdata, const matrix_t& g, cons
     } else {
         //high-degree version
         //add 4*sizeof(part_t) for alignment reasons I think
-        Kokkos::parallel_for("init conn DS (team)", team_policy_t(g.numRows(), Kokkos::AUTO).set_scratch_size(0, Kokkos::PerTeam(k*sizeof(gain_t) + k*sizeof(part_t) + 4*sizeof(part_t))), KOKKOS_LAMBDA(const member& t){
+        size_t table_bytes = cdata.max_table_size*(sizeof(gain_t) + sizeof(part_t)) + 4*sizeof(part_t);
+        Kokkos::parallel_for("init conn DS (team)", team_policy_t(exec, g.numRows(), Kokkos::AUTO).set_scratch_size(0, Kokkos::PerTeam(table_bytes)), KOKKOS_LAMBDA(const member& t){
             build_row_cdata_large(cdata, g, part, k, t);
         });
     }
@@ -1057,9 +1227,9 @@ void jet_refine(const matrix_t g, const config_t& config, wgt_vt vtx_w, part_vt
     part_t k = config.num_parts;
     double imb_ratio = config.max_imb_ratio;
     if(!best_state.init){
-        best_state.cut = stat::get_total_cut(g, best_part);
-        best_state.part_sizes = stat::get_part_sizes(g, vtx_w, best_part, k);
-        best_state.total_size = stat::get_total_size(g, vtx_w);
+        best_state.cut = stat::get_total_cut(g, best_part, exec);
+        best_state.part_sizes = stat::get_part_sizes(g, vtx_w, best_part, k, exec);
+        best_state.total_size = stat::get_total_size(g, vtx_w, exec);
     }
     problem prob;
     prob.g = g;
@@ -1068,40 +1238,49 @@ void jet_refine(const matrix_t g, const config_t& config, wgt_vt vtx_w, part_vt
     prob.vtx_w = vtx_w;
     prob.opt = stat::optimal_size(best_state.total_size, k);
     prob.size_max = prob.opt*imb_ratio;
+    prob.max_buckets = gain_buckets(config);
+    prob.max_sections = gain_sections(config);
+    prob.update_large_ratio = config.update_large_ratio;
     if(!best_state.init){
         best_state.init = true;
-        gain_t max_size = stat::largest_part_size(best_state.part_sizes);
+        gain_t max_size = stat::largest_part_size(best_state.part_sizes, exec);
         best_state.total_imb = max_size > prob.opt ? max_size - prob.opt : 0;
         std::cout << "Initial " << std::fixed << (best_state.cut / 2) << " " << std::setprecision(6) << (static_cast<double>(best_state.total_imb) / static_cast<double>(prob.opt)) << " ";
         std::cout << g.numRows() << std::endl;
     }
     refine_data curr_state = clone_refine_data(best_state);
     gain_t imb_max = prob.size_max - prob.opt;
-    part_vt part(Kokkos::ViewAllocateWithoutInitializing("current partition"), g.numRows());
-    Kokkos::deep_copy(exec_space(), part, best_part);
+    part_vt part = Kokkos::subview(scratch.current_part, std::make_pair(static_cast<ordinal_t>(0), g.numRows()));
+    Kokkos::deep_copy(exec, part, best_part);
     conn_data cdata = init_conn_data(perm_cdata, g, part, k);
     int iter_count = 0;
-    Kokkos::fence();
+    exec.fence();
     Kokkos::Timer iter_t;
     int balance_counter = 0;
     int lab_counter = 0;
     double tol = config.refine_tolerance;
     std::vector<double> temps;
-    if(config.ultra_settings){
-        for(double t = 0.85; t > 0; t -= 0.05){
+    if(config.ultra_settings && config.ultra_temp_step > 0){
+        for(double t = config.ultra_temp_start; t > 0; t -= config.ultra_temp_step){
             temps.push_back(t);
         }
     } else if(uniform_ew) {
-        temps.push_back(0.25);
+        temps.push_back(config.lp_temp_uniform);
     } else {
-        temps.push_back(0.75);
+        temps.push_back(config.lp_temp_weighted);
     }
-    //repeat until 12 phases since a significant
+    int patience = config.refine_patience;
+    bool stopped = config.expired();
+    //repeat until patience (12 by default) phases since a significant
     //improvement in cut or balance
-    //this accounts for at least 3 full lp+rebalancing cycles
+    //by default this accounts for at least 3 full lp+rebalancing cycles
     for(double filter_ratio : temps){
         int count = 0;
-        while(count++ <= 11){
+        while(!stopped && count++ < patience){
+            if(config.expired()){
+                stopped = true;
+                break;
+            }
             iter_count++;
             vtx_vt moves;
             if(curr_state.total_imb <= imb_max){
@@ -1120,7 +1299,7 @@ void jet_refine(const matrix_t g, const config_t& config, wgt_vt vtx_w, part_vt
             //copy current partition and relevant data to output partition if following conditions pass
             if(best_state.total_imb > imb_max && curr_state.total_imb < best_state.total_imb){
                 copy_refine_data(best_state, curr_state);
-                Kokkos::deep_copy(exec_space(), best_part, part);
+                Kokkos::deep_copy(exec, best_part, part);
                 count = 0;
             } else if(curr_state.cut < best_state.cut && (curr_state.total_imb <= imb_max || curr_state.total_imb <= best_state.total_imb)){
                 //do not reset counter if cut improvement is too small
@@ -1128,11 +1307,32 @@ void jet_refine(const matrix_t g, const config_t& config, wgt_vt vtx_w, part_vt
                     count = 0;
                 }
                 copy_refine_data(best_state, curr_state);
-                Kokkos::deep_copy(exec_space(), best_part, part);
+                Kokkos::deep_copy(exec, best_part, part);
+            }
+        }
+    }
+    //out of time: only rebalance, until the best partition is balanced or balance stops improving
+    if(stopped){
+        experiment.setTruncated(true);
+        int count = 0;
+        while(best_state.total_imb > imb_max && count++ < patience){
+            iter_count++;
+            vtx_vt moves;
+            if(balance_counter < 2){
+                moves = rebalance_weak(prob, part, cdata, scratch, curr_state.part_sizes);
+            } else {
+                moves = rebalance_strong(prob, part, cdata, scratch, curr_state.part_sizes);
+            }
+            balance_counter++;
+            perform_moves(prob, part, moves, scratch.dest_part, scratch, cdata, curr_state);
+            if(curr_state.total_imb < best_state.total_imb){
+                copy_refine_data(best_state, curr_state);
+                Kokkos::deep_copy(exec, best_part, part);
+                count = 0;
             }
         }
     }
-    Kokkos::fence();
+    exec.fence();
     double best_imb_ratio = static_cast<double>(best_state.total_imb) / static_cast<double>(prob.opt);
     //divide cut by 2 because each cut edge is counted from both sides
     typename experiment_data<scalar_t>::CoarseLevel cl(best_state.cut / 2, best_imb_ratio, g.nnz(), g.numRows(), y.seconds(), iter_t.seconds(), iter_count, lab_counter);
@@ -74,10 +74,10 @@ public:
     using member = typename team_policy_t::member_type;
     static constexpr bool is_host_space = std::is_same<typename exec_space::memory_space, typename Kokkos::DefaultHostExecutionSpace::memory_space>::value;
 
-static gain_t get_total_cut(const matrix_t g, const part_vt partition){
+static gain_t get_total_cut(const matrix_t g, const part_vt partition, const exec_space& exec = exec_space()){
     gain_t total_cut = 0;
     if(!is_host_space ){
-        Kokkos::parallel_reduce("find total cut (team)", team_policy_t(g.numRows(), Kokkos::AUTO), KOKKOS_LAMBDA(const member& t, gain_t& update){
+        Kokkos::parallel_reduce("find total cut (team)", team_policy_t(exec, g.numRows(), Kokkos::AUTO), KOKKOS_LAMBDA(const member& t, gain_t& update){
             gain_t local_cut = 0;
             ordinal_t i = t.league_rank();
             Kokkos::parallel_reduce(Kokkos::TeamThreadRange(t, g.graph.row_map(i), g.graph.row_map(i + 1)), [=] (const edge_offset_t j, gain_t& local_update){
@@ -92,7 +92,7 @@ static gain_t get_total_cut(const matrix_t g, const part_vt partition){
             });
         }, total_cut);
     } else {
-        Kokkos::parallel_reduce("find total cut", policy_t(0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t i, gain_t& update){
+        Kokkos::parallel_reduce("find total cut", policy_t(exec, 0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t i, gain_t& update){
             gain_t local_cut = 0;
             for(edge_offset_t j = g.graph.row_map(i); j < g.graph.row_map(i + 1); j++) {
                 ordinal_t v = g.graph.entries(j);
@@ -113,9 +113,10 @@ static ordinal_t optimal_size(const ordinal_t total_size, const part_t k){
     return (total_size + k - 1) / k;
 }
 
-static gain_2vt cut_heatmap(const matrix_t g, const part_vt partition, const part_t k){
+//allocates k*k entries, prefer cut_per_part or max_part_cut for large k
+static gain_2vt cut_heatmap(const matrix_t g, const part_vt partition, const part_t k, const exec_space& exec = exec_space()){
     gain_2vt heatmap("heatmap", k, k);
-    Kokkos::parallel_for("create cut heatmap (team)", team_policy_t(g.numRows(), Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
+    Kokkos::parallel_for("create cut heatmap (team)", team_policy_t(exec, g.numRows(), Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
         ordinal_t i = t.league_rank();
         Kokkos::parallel_for(Kokkos::TeamThreadRange(t, g.graph.row_map(i), g.graph.row_map(i + 1)), [=] (const edge_offset_t j){
             ordinal_t v = g.graph.entries(j);
@@ -128,9 +129,9 @@ static gain_2vt cut_heatmap(const matrix_t g, const part_vt partition, const par
     return heatmap;
 }
 
-static gain_vt cut_per_part(const matrix_t g, const part_vt partition, const part_t k){
+static gain_vt cut_per_part(const matrix_t g, const part_vt partition, const part_t k, const exec_space& exec = exec_space()){
     gain_vt heatmap("heatmap", k);
-    Kokkos::parallel_for("find cut per part (team)", team_policy_t(g.numRows(), Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
+    Kokkos::parallel_for("find cut per part (team)", team_policy_t(exec, g.numRows(), Kokkos::AUTO), KOKKOS_LAMBDA(const member& t){
         ordinal_t i = t.league_rank();
         Kokkos::parallel_for(Kokkos::TeamThreadRange(t, g.graph.row_map(i), g.graph.row_map(i + 1)), [=] (const edge_offset_t j){
             ordinal_t v = g.graph.entries(j);
@@ -143,9 +144,9 @@ static gain_vt cut_per_part(const matrix_t g, const part_vt partition, const par
     return heatmap;
 }
 
-static gain_vt get_part_sizes(const matrix_t g, const wgt_vt vtx_w, const part_vt partition, part_t k){
+static gain_vt get_part_sizes(const matrix_t g, const wgt_vt vtx_w, const part_vt partition, part_t k, const exec_space& exec = exec_space()){
     gain_vt part_size("part sizes", k);
-    Kokkos::parallel_for("calc part sizes", policy_t(0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t i){
+    Kokkos::parallel_for("calc part sizes", policy_t(exec, 0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t i){
         part_t p = partition(i);
         Kokkos::atomic_add(&part_size(p), vtx_w(i));
     });
@@ -153,17 +154,17 @@ static gain_vt get_part_sizes(const matrix_t g, const wgt_vt vtx_w, const part_v
 }
 
 //get sum of vertex weights
-static scalar_t get_total_size(const matrix_t g, const wgt_vt vtx_w){
+static scalar_t get_total_size(const matrix_t g, const wgt_vt vtx_w, const exec_space& exec = exec_space()){
     scalar_t total_size = 0;
-    Kokkos::parallel_reduce("sum of vertex weights", policy_t(0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t i, scalar_t& update){
+    Kokkos::parallel_reduce("sum of vertex weights", policy_t(exec, 0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t i, scalar_t& update){
         update += vtx_w(i);
     }, total_size);
     return total_size;
 }
 
-static gain_t largest_part_size(const gain_vt& ps){
+static gain_t largest_part_size(const gain_vt& ps, const exec_space& exec = exec_space()){
     gain_t result = 0;
-    Kokkos::parallel_reduce("get max part size", policy_t(0, ps.extent(0)), KOKKOS_LAMBDA(const ordinal_t i, gain_t& update){
+    Kokkos::parallel_reduce("get max part size", policy_t(exec, 0, ps.extent(0)), KOKKOS_LAMBDA(const ordinal_t i, gain_t& update){
         if(ps(i) > update){
             update = ps(i);
         }
@@ -171,28 +172,28 @@ static gain_t largest_part_size(const gain_vt& ps){
     return result;
 }
 
-static void stash_largest(const gain_vt& ps, gain_pin_st& result){
-    Kokkos::parallel_reduce("get max part size (store in view)", policy_t(0, ps.extent(0)), KOKKOS_LAMBDA(const ordinal_t i, gain_t& update){
+static void stash_largest(const gain_vt& ps, gain_pin_st& result, const exec_space& exec = exec_space()){
+    Kokkos::parallel_reduce("get max part size (store in view)", policy_t(exec, 0, ps.extent(0)), KOKKOS_LAMBDA(const ordinal_t i, gain_t& update){
         if(ps(i) > update){
             update = ps(i);
         }
     }, Kokkos::Max<gain_t, typename gain_pin_st::memory_space>(result));
 }
 
-static gain_t max_part_cut(const matrix_t g, part_vt part, const part_t k){
-    return largest_part_size(cut_per_part(g, part, k));
+static gain_t max_part_cut(const matrix_t g, part_vt part, const part_t k, const exec_space& exec = exec_space()){
+    return largest_part_size(cut_per_part(g, part, k, exec), exec);
 }
 
-static scalar_t comm_size(const matrix_t& g, const part_vt& part, part_t k){
+static scalar_t comm_size(const matrix_t& g, const part_vt& part, part_t k, const exec_space& exec = exec_space()){
     ordinal_t n = g.numRows();
     edge_vt conn_offsets("comp offsets", n + 1);
-    Kokkos::parallel_for("comp conn row size", policy_t(0, n), KOKKOS_LAMBDA(const ordinal_t& i){
+    Kokkos::parallel_for("comp conn row size", policy_t(exec, 0, n), KOKKOS_LAMBDA(const ordinal_t& i){
         ordinal_t degree = g.graph.row_map(i + 1) - g.graph.row_map(i);
         if(degree > static_cast<ordinal_t>(k)) degree = k;
         conn_offsets(i + 1) = degree;
     });
     edge_offset_t gain_size = 0;
-    Kokkos::parallel_scan("comp conn offsets", policy_t(0, n + 1), KOKKOS_LAMBDA(const ordinal_t& i, edge_offset_t& update, const bool final){
+    Kokkos::parallel_scan("comp conn offsets", policy_t(exec, 0, n + 1), KOKKOS_LAMBDA(const ordinal_t& i, edge_offset_t& update, const bool final){
         update += conn_offsets(i);
         if(final){
             conn_offsets(i) = update;
@@ -200,9 +201,9 @@ static scalar_t comm_size(const matrix_t& g, const part_vt& part, part_t k){
     }, gain_size);
     part_vt conn_entries("conn entries", gain_size);
     part_t NULL_PART = -1;
-    Kokkos::deep_copy(exec_space(), conn_entries, NULL_PART);
+    Kokkos::deep_copy(exec, conn_entries, NULL_PART);
     scalar_t result = 0;
-    Kokkos::parallel_reduce("find communication volume", policy_t(0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t& i, scalar_t& update){
+    Kokkos::parallel_reduce("find communication volume", policy_t(exec, 0, g.numRows()), KOKKOS_LAMBDA(const ordinal_t& i, scalar_t& update){
         edge_offset_t g_start = conn_offsets(i);
         edge_offset_t g_end = conn_offsets(i + 1);
         part_t size = g_end - g_start;
@@ -228,10 +229,10 @@ static scalar_t comm_size(const matrix_t& g, const part_vt& part, part_t k){
     return result;
 }
 
-static int64_t least_squares(const matrix_t g, part_vt part, const part_t k){
-    gain_vt ex_cut = cut_per_part(g, part, k);
+static int64_t least_squares(const matrix_t g, part_vt part, const part_t k, const exec_space& exec = exec_space()){
+    gain_vt ex_cut = cut_per_part(g, part, k, exec);
     int64_t result = 0;
-    Kokkos::parallel_reduce("least squares", policy_t(0, k), KOKKOS_LAMBDA(const part_t p, int64_t& res){
+    Kokkos::parallel_reduce("least squares", policy_t(exec, 0, k), KOKKOS_LAMBDA(const part_t p, int64_t& res){
         int64_t ex = ex_cut(p);
         res += ex*ex;
     }, result);
@@ -39,6 +39,12 @@
 #include "contract.hpp"
 #include "uncoarsen.hpp"
 #include "initial_partition.hpp"
+#include "hierarchy_cache.hpp"
+#include <memory>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
 
 namespace jet_partitioner {
 
@@ -47,31 +53,44 @@ class partitioner {
 public:
 
     using matrix_t = crsMat;
+    using exec_space = typename matrix_t::execution_space;
     using Device = typename matrix_t::device_type;
     using ordinal_t = typename matrix_t::ordinal_type;
     using scalar_t = typename matrix_t::value_type;
+    using edge_offset_t = typename matrix_t::size_type;
+    using graph_t = typename matrix_t::staticcrsgraph_type;
     using wgt_vt = Kokkos::View<scalar_t*, Device>;
     using part_vt = Kokkos::View<part_t*, Device>;
     using coarsener_t = contracter<matrix_t>;
     using init_t = initial_partitioner<matrix_t, part_t>;
     using uncoarsener_t = uncoarsener<matrix_t, part_t>;
     using coarse_level_triple = typename coarsener_t::coarse_level_triple;
+    using cache_t = hierarchy_cache<matrix_t, part_t>;
     using stat = part_stat<matrix_t, part_t>;
+    using ref_t = typename uncoarsener_t::ref_t;
 
-static part_vt partition(scalar_t& edge_cut,
-                                  const config_t& config,
-                                  const matrix_t g,
-                                  const wgt_vt vweights,
-                                  bool uniform_ew,
-                                  experiment_data<scalar_t>& experiment) {
-
+//memory kept between partition calls that share a workspace
+//the contracter owns the coarsening scratch and the random pool, the refiner owns the refinement scratch
+struct workspace {
     coarsener_t coarsener;
+    std::unique_ptr<ref_t> refiner;
+};
 
-    Kokkos::fence();
-    Kokkos::Timer t;
-    double start_time = t.seconds();
-    part_t k = config.num_parts;
+//coarsening stops once the graph has at most this many vertices
+static ordinal_t coarse_cutoff(const config_t& config, part_t k){
+    if(config.coarse_cutoff > 0) return config.coarse_cutoff;
+    int per_part = std::max(config.coarse_vertices_per_part, 1);
+    int cutoff = k*per_part;
+    if(cutoff > 1024){
+        cutoff = k*per_part / 4;
+        cutoff = std::max(1024, cutoff);
+    }
+    return cutoff;
+}
 
+static void configure_coarsener(coarsener_t& coarsener, const config_t& config, ordinal_t cutoff, const exec_space& exec){
+    //all work is launched on exec, so that attempts on separate instances can run concurrently
+    coarsener.set_exec_space(exec);
     switch(config.coarsening_alg){
         case 0:
             coarsener.set_heuristic(coarsener_t::MtMetis);
@@ -85,44 +104,351 @@ static part_vt partition(scalar_t& edge_cut,
         default:
             coarsener.set_heuristic(coarsener_t::MtMetis);
     }
-    int cutoff = k*8;
-    if(cutoff > 1024){
-        cutoff = k*2;
-        cutoff = std::max(1024, cutoff);
-    }
     coarsener.set_coarse_vtx_cutoff(cutoff);
     coarsener.set_min_allowed_vtx(cutoff / 4);
-    std::list<coarse_level_triple> cg_list = coarsener.generate_coarse_graphs(g, vweights, experiment, uniform_ew);
-    Kokkos::fence();
+    coarsener.set_max_levels(config.max_levels);
+    coarsener.set_seed(config.seed);
+}
+
+//loads the coarse hierarchy from the cache or generates it
+//cached coarse graphs may alias cache_file, so it must outlive the returned list
+//the cache is only used with a fixed seed, as seed 0 asks for a fresh random hierarchy on every attempt
+static std::list<coarse_level_triple> coarsen(coarsener_t& coarsener, const config_t& config, const matrix_t g,
+    const wgt_vt vweights, bool uniform_ew, experiment_data<scalar_t>& experiment, mapped_file& cache_file,
+    bool reuse, const exec_space& exec){
+
+    std::list<coarse_level_triple> cg_list;
+    std::string cache_path;
+    if(config.hierarchy_cache_dir != nullptr && config.seed != 0){
+        uint64_t key = cache_t::key(g, vweights, uniform_ew, coarsener.h, config.seed,
+            coarsener.coarse_vtx_cutoff, coarsener.min_allowed_vtx, coarsener.max_levels, exec);
+        cache_path = cache_t::path(config.hierarchy_cache_dir, key);
+        coarse_level_triple finest;
+        finest.mtx = g;
+        finest.vtx_w = vweights;
+        finest.level = 1;
+        finest.uniform_weights = uniform_ew;
+        if(cache_t::load(cache_path, cache_file, finest, cg_list) && config.verbose){
+            std::cout << "Loaded coarse hierarchy from " << cache_path << std::endl;
+        }
+    }
+    if(cg_list.empty()){
+        cg_list = coarsener.generate_coarse_graphs(g, vweights, experiment, uniform_ew);
+        if(!cache_path.empty()) cache_t::store(cache_path, cg_list);
+        //free the coarsening scratch before refinement unless it will be reused
+        if(!reuse) coarsener.scratch = typename coarsener_t::scratch_mem();
+    }
+    return cg_list;
+}
+
+static void report(const config_t& config, const matrix_t g, part_vt part, experiment_data<scalar_t>& experiment, const exec_space& exec){
+    if(config.verbose){
+        // additional partition statistics
+        experiment.setMaxPartCut(stat::max_part_cut(g, part, config.num_parts, exec));
+        experiment.setObjective(stat::comm_size(g, part, config.num_parts, exec));
+
+        experiment.refinementReport();
+        experiment.verboseReport();
+    }
+}
+
+static part_vt partition(scalar_t& edge_cut,
+                                  const config_t& config,
+                                  const matrix_t g,
+                                  const wgt_vt vweights,
+                                  bool uniform_ew,
+                                  experiment_data<scalar_t>& experiment,
+                                  const exec_space& exec = exec_space(),
+                                  workspace* ws = nullptr,
+                                  part_vt out = part_vt()) {
+
+    //without a workspace, scratch memory only lives for this call
+    workspace local;
+    bool reuse = (ws != nullptr);
+    if(!reuse) ws = &local;
+    coarsener_t& coarsener = ws->coarsener;
+
+    exec.fence();
+    Kokkos::Timer t;
+    double start_time = t.seconds();
+    part_t k = config.num_parts;
+
+    configure_coarsener(coarsener, config, coarse_cutoff(config, k), exec);
+    mapped_file cache_file;
+    std::list<coarse_level_triple> cg_list = coarsen(coarsener, config, g, vweights, uniform_ew, experiment, cache_file, reuse, exec);
+    exec.fence();
     double fin_coarsening_time = t.seconds();
     double imb_ratio = config.max_imb_ratio;
-    part_vt coarsest_p = init_t::metis_init(cg_list.back().mtx, cg_list.back().vtx_w, k, imb_ratio);
+    part_vt coarsest_p = init_t::metis_init(cg_list.back().mtx, cg_list.back().vtx_w, k, imb_ratio, exec);
     //part_vt coarsest_p = init_t::random_init(cg_list.back().vtx_w, k, imb_ratio);
-    Kokkos::fence();
+    exec.fence();
     experiment.addMeasurement(Measurement::InitPartition, t.seconds() - fin_coarsening_time);
     part_vt part = uncoarsener_t::uncoarsen(cg_list, coarsest_p, config,
-        edge_cut, experiment);
+        edge_cut, experiment, ws->refiner, exec, out);
 
-    Kokkos::fence();
+    exec.fence();
     double fin_uncoarsening = t.seconds();
     cg_list.clear();
-    Kokkos::fence();
+    exec.fence();
     double fin_time = t.seconds();
     experiment.addMeasurement(Measurement::Total, fin_time - start_time);
     experiment.addMeasurement(Measurement::Coarsen, fin_coarsening_time - start_time);
     experiment.addMeasurement(Measurement::FreeGraph, fin_time - fin_uncoarsening);
     
-    if(config.verbose){
-        // additional partition statistics
-        experiment.setMaxPartCut(stat::max_part_cut(g, part, k));
-        experiment.setObjective(stat::comm_size(g, part, k));
+    report(config, g, part, experiment, exec);
 
-        experiment.refinementReport();
-        experiment.verboseReport();
-    }
+    return part;
+}
+
+//warm start: refines an existing partition of g in place instead of partitioning from scratch
+//only the finest graph is refined, so coarsening and initial partitioning are skipped
+//part must hold a part id in [0, config.num_parts) for every vertex
+static part_vt refine(scalar_t& edge_cut,
+                                  const config_t& config,
+                                  const matrix_t g,
+                                  const wgt_vt vweights,
+                                  bool uniform_ew,
+                                  part_vt part,
+                                  experiment_data<scalar_t>& experiment,
+                                  const exec_space& exec = exec_space(),
+                                  workspace* ws = nullptr) {
+
+    workspace local;
+    if(ws == nullptr) ws = &local;
+    //there is no hierarchy to write
+    config_t refine_config = config;
+    refine_config.dump_coarse = false;
+
+    exec.fence();
+    Kokkos::Timer t;
+    std::list<coarse_level_triple> cg_list;
+    coarse_level_triple finest;
+    finest.mtx = g;
+    finest.vtx_w = vweights;
+    finest.level = 1;
+    finest.uniform_weights = uniform_ew;
+    cg_list.push_back(finest);
+    part = uncoarsener_t::uncoarsen(cg_list, part, refine_config,
+        edge_cut, experiment, ws->refiner, exec);
+    exec.fence();
+    experiment.addMeasurement(Measurement::Total, t.seconds());
+
+    report(refine_config, g, part, experiment, exec);
 
     return part;
 }
+
+//runs partition on a thread of its own and returns immediately
+//every kernel and fence of the call is scoped to exec, so the caller may load and build the next graph meanwhile
+//g, vweights and ws are held until the future is ready, ws may not be shared with other running calls
+template<class result_t>
+static std::future<result_t> partition_async(const config_t& config,
+                                  const matrix_t g,
+                                  const wgt_vt vweights,
+                                  bool uniform_ew,
+                                  const exec_space& exec,
+                                  workspace* ws = nullptr) {
+
+    return std::async(std::launch::async, [=](){
+        result_t result;
+        result.part = partition(result.edge_cut, config, g, vweights, uniform_ew, result.experiment, exec, ws);
+        exec.fence();
+        return result;
+    });
+}
+
+//partitions a graph held in caller-owned CSR arrays, which are wrapped in unmanaged views instead of copied
+//the arrays must be accessible from exec and are only read, part is written directly as the finest level's partition
+//without adjwgt every edge has weight 1 and without vwgt every vertex has weight 1, which allocates those weights
+//a missing adjwgt costs an nnz-sized array, so callers near their memory limit should pass unit weights themselves
+static void partition_csr(scalar_t& edge_cut,
+                                  const config_t& config,
+                                  ordinal_t n,
+                                  const edge_offset_t* xadj,
+                                  const ordinal_t* adjncy,
+                                  const scalar_t* adjwgt,
+                                  const scalar_t* vwgt,
+                                  part_t* part,
+                                  experiment_data<scalar_t>& experiment,
+                                  const exec_space& exec = exec_space(),
+                                  workspace* ws = nullptr) {
+
+    using unmanaged = Kokkos::MemoryTraits<Kokkos::Unmanaged>;
+    edge_offset_t nnz = 0;
+    Kokkos::View<const edge_offset_t*, Device, unmanaged> rows(xadj, n + 1);
+    Kokkos::deep_copy(exec, nnz, Kokkos::subview(rows, n));
+    exec.fence();
+    //the partitioner never writes to its input graph
+    typename graph_t::entries_type entries = Kokkos::View<ordinal_t*, Device, unmanaged>(const_cast<ordinal_t*>(adjncy), nnz);
+    typename graph_t::row_map_type::non_const_type row_map = Kokkos::View<edge_offset_t*, Device, unmanaged>(const_cast<edge_offset_t*>(xadj), n + 1);
+    typename matrix_t::values_type::non_const_type values;
+    if(adjwgt != nullptr){
+        values = Kokkos::View<scalar_t*, Device, unmanaged>(const_cast<scalar_t*>(adjwgt), nnz);
+    } else {
+        values = typename matrix_t::values_type::non_const_type(Kokkos::ViewAllocateWithoutInitializing("edge weights"), nnz);
+        Kokkos::deep_copy(exec, values, 1);
+    }
+    wgt_vt vweights;
+    if(vwgt != nullptr){
+        vweights = Kokkos::View<scalar_t*, Device, unmanaged>(const_cast<scalar_t*>(vwgt), n);
+    } else {
+        vweights = wgt_vt(Kokkos::ViewAllocateWithoutInitializing("vertex weights"), n);
+        Kokkos::deep_copy(exec, vweights, 1);
+    }
+    graph_t graph(entries, row_map);
+    matrix_t g("csr graph", n, values, graph);
+    part_vt out = Kokkos::View<part_t*, Device, unmanaged>(part, n);
+    partition(edge_cut, config, g, vweights, adjwgt == nullptr, experiment, exec, ws, out);
+    exec.fence();
+}
+
+//the prefix of a hierarchy at which coarsening with the given cutoff would have stopped
+//levels below cutoff / 4 vertices are rejected, as in generate_coarse_graphs
+static std::list<coarse_level_triple> truncate_levels(const std::list<coarse_level_triple>& cg_list, ordinal_t cutoff){
+    ordinal_t min_allowed = cutoff / 4;
+    std::list<coarse_level_triple> levels;
+    for(const coarse_level_triple& level : cg_list){
+        if(!levels.empty() && level.mtx.numRows() < min_allowed) break;
+        levels.push_back(level);
+        if(level.mtx.numRows() <= cutoff) break;
+    }
+    return levels;
+}
+
+//partitions g once for every part count, sharing one coarse hierarchy
+//the hierarchy is coarsened to the smallest cutoff of all part counts, and each part count
+//is initially partitioned and uncoarsened from the level at which its own cutoff stops
+//config.num_parts is ignored, edge_cuts and experiments receive one entry per part count
+static std::vector<part_vt> partition_sweep(std::vector<scalar_t>& edge_cuts,
+                                  const config_t& config,
+                                  const std::vector<part_t>& part_counts,
+                                  const matrix_t g,
+                                  const wgt_vt vweights,
+                                  bool uniform_ew,
+                                  std::vector<experiment_data<scalar_t>>& experiments,
+                                  const exec_space& exec = exec_space(),
+                                  workspace* ws = nullptr) {
+
+    size_t count = part_counts.size();
+    std::vector<part_vt> parts(count);
+    edge_cuts.assign(count, 0);
+    experiments.assign(count, experiment_data<scalar_t>());
+    if(count == 0) return parts;
+    workspace local;
+    bool reuse = (ws != nullptr);
+    if(!reuse) ws = &local;
+    coarsener_t& coarsener = ws->coarsener;
+
+    ordinal_t cutoff = coarse_cutoff(config, part_counts[0]);
+    for(part_t k : part_counts){
+        cutoff = std::min(cutoff, coarse_cutoff(config, k));
+    }
+    //every part count would write its own hierarchy to the same file
+    config_t sweep_config = config;
+    sweep_config.dump_coarse = false;
+
+    exec.fence();
+    Kokkos::Timer t;
+    experiment_data<scalar_t> coarse_experiment;
+    configure_coarsener(coarsener, config, cutoff, exec);
+    mapped_file cache_file;
+    std::list<coarse_level_triple> cg_list = coarsen(coarsener, config, g, vweights, uniform_ew, coarse_experiment, cache_file, reuse, exec);
+    exec.fence();
+    double coarsening_time = t.seconds();
+    coarse_experiment.addMeasurement(Measurement::Coarsen, coarsening_time);
+
+    for(size_t i = 0; i < count; i++){
+        part_t k = part_counts[i];
+        sweep_config.num_parts = k;
+        //the shared coarsening time is reported for every part count
+        experiment_data<scalar_t>& experiment = experiments[i];
+        experiment = coarse_experiment;
+        std::list<coarse_level_triple> levels = truncate_levels(cg_list, coarse_cutoff(config, k));
+        t.reset();
+        part_vt coarsest_p = init_t::metis_init(levels.back().mtx, levels.back().vtx_w, k, config.max_imb_ratio, exec);
+        exec.fence();
+        experiment.addMeasurement(Measurement::InitPartition, t.seconds());
+        parts[i] = uncoarsener_t::uncoarsen(levels, coarsest_p, sweep_config,
+            edge_cuts[i], experiment, ws->refiner, exec);
+        exec.fence();
+        experiment.addMeasurement(Measurement::Total, coarsening_time + t.seconds());
+        report(sweep_config, g, parts[i], experiment, exec);
+    }
+    return parts;
+}
+
+//default number of concurrent instances for a batch of small graphs
+//a few host threads per graph keep a small graph busy, devices overlap a handful of streams
+static int batch_instances(size_t count){
+    int instances = 4;
+    if(Kokkos::SpaceAccessibility<Kokkos::HostSpace, typename exec_space::memory_space>::accessible){
+        instances = std::max(1, exec_space().concurrency() / 4);
+    }
+    return std::min<size_t>(instances, count);
+}
+
+//partitions each graph of a batch independently with the same config
+//the execution space is split into instance_count instances (0 picks a default), each served by one thread
+//that takes graphs from a shared queue and keeps its own workspace, so scratch memory is allocated once per instance
+//seconds receives the wall time of the whole batch
+static std::vector<part_vt> partition_batch(std::vector<scalar_t>& edge_cuts,
+                                  const config_t& config,
+                                  const std::vector<matrix_t>& graphs,
+                                  const std::vector<wgt_vt>& vweights,
+                                  const std::vector<bool>& uniform_ew,
+                                  int instance_count,
+                                  double& seconds) {
+
+    size_t count = graphs.size();
+    std::vector<part_vt> parts(count);
+    edge_cuts.assign(count, 0);
+    seconds = 0;
+    if(count == 0) return parts;
+    if(instance_count <= 0) instance_count = batch_instances(count);
+    instance_count = std::min<size_t>(instance_count, count);
+    std::vector<exec_space> instances = {exec_space()};
+    if(instance_count > 1){
+        instances = Kokkos::Experimental::partition_space(exec_space(), std::vector<int>(instance_count, 1));
+    }
+    //per-graph reports would interleave, and every graph would write the same hierarchy file
+    config_t batch_config = config;
+    batch_config.verbose = false;
+    batch_config.dump_coarse = false;
+
+    std::atomic<size_t> next(0);
+    //only the instances of this batch are waited on, so unrelated work elsewhere in the process is not
+    //the instances are split from exec_space(), which may still be building the input graphs
+    exec_space().fence();
+    for(const exec_space& e : instances){
+        e.fence();
+    }
+    Kokkos::Timer t;
+    auto worker = [&](int w){
+        workspace ws;
+        for(size_t i = next++; i < count; i = next++){
+            experiment_data<scalar_t> experiment;
+            parts[i] = partition(edge_cuts[i], batch_config, graphs[i], vweights[i], uniform_ew[i], experiment, instances[w], &ws);
+        }
+        instances[w].fence();
+    };
+    if(instances.size() == 1){
+        worker(0);
+    } else {
+        std::vector<std::thread> threads;
+        for(size_t w = 0; w < instances.size(); w++){
+            threads.emplace_back(worker, w);
+        }
+        for(std::thread& th : threads){
+            th.join();
+        }
+    }
+    seconds = t.seconds();
+    if(config.verbose){
+        std::cout << "Partitioned " << count << " graphs on " << instances.size() << " instances in " << seconds
+            << " seconds (" << count / seconds << " graphs/second)" << std::endl;
+    }
+    return parts;
+}
 };
 
 }
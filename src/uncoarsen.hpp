@@ -43,6 +43,8 @@
 #include "KokkosSparse_CrsMatrix.hpp"
 #include "part_stat.hpp"
 #include "binary_dump.hpp"
+#include <memory>
+#include <algorithm>
 
 namespace jet_partitioner {
 
@@ -54,6 +56,7 @@ public:
     using exec_space = typename matrix_t::execution_space;
     using Device = typename matrix_t::device_type;
     using ordinal_t = typename matrix_t::ordinal_type;
+    using edge_offset_t = typename matrix_t::size_type;
     using scalar_t = typename matrix_t::value_type;
     using vtx_vt = Kokkos::View<ordinal_t*, Device>;
     using part_vt = Kokkos::View<part_t*, Device>;
@@ -79,15 +82,45 @@ static double get_max_imb(gain_vt part_sizes, part_t k){
     return static_cast<double>(imb) / static_cast<double>(stat::optimal_size(fine_n, k));
 }
 
-static void project(ordinal_t fine_n, vtx_vt map, part_vt input, part_vt output){
-    Kokkos::parallel_for("project", policy_t(0, fine_n), KOKKOS_LAMBDA(const ordinal_t i){
+static void project(ordinal_t fine_n, vtx_vt map, part_vt input, part_vt output, const exec_space& exec){
+    Kokkos::parallel_for("project", policy_t(exec, 0, fine_n), KOKKOS_LAMBDA(const ordinal_t i){
         output(i) = input(map(i));
     });
 }
 
-static part_vt multilevel_jet(std::list<clt> cg_list, part_vt coarse_guess, const config_t& config, rfd_t& rfd, experiment_data<scalar_t>& experiment, Kokkos::Timer& t){
+//returns a refiner whose scratch memory fits every level of a hierarchy with finest graph g
+//an existing refiner is reused when it is large enough, otherwise it is replaced by one that also covers its old size
+static ref_t& prepare_refiner(std::unique_ptr<ref_t>& refiner, const matrix_t& g, const config_t& config, const exec_space& exec){
     part_t k = config.num_parts;
-    ref_t refiner(cg_list.front().mtx, k);
+    if(refiner != nullptr && refiner->fits(g, config)){
+        refiner->exec = exec;
+        return *refiner;
+    }
+    ordinal_t n = g.numRows();
+    edge_offset_t gain_size = ref_t::count_gain_size(g, k, exec);
+    ordinal_t minibuckets = 0;
+    if(refiner != nullptr && refiner->capacity_k == k){
+        n = std::max(n, refiner->capacity_n);
+        gain_size = std::max(gain_size, refiner->capacity_gain);
+        minibuckets = refiner->capacity_minibuckets;
+    }
+    //the eviction method depends on the capacity, so the grid is sized for the final n
+    minibuckets = std::max(minibuckets, ref_t::minibucket_count(config, k, n));
+    refiner.reset();
+    refiner = std::make_unique<ref_t>(n, gain_size, k, minibuckets, exec);
+    return *refiner;
+}
+
+//the partition of the finest level is written to finest if it is non-empty
+static part_vt multilevel_jet(std::list<clt> cg_list, part_vt coarse_guess, const config_t& config, rfd_t& rfd, experiment_data<scalar_t>& experiment, Kokkos::Timer& t, std::unique_ptr<ref_t>& refiner_mem, const exec_space& exec, part_vt finest){
+    part_t k = config.num_parts;
+    ref_t& refiner = prepare_refiner(refiner_mem, cg_list.front().mtx, config, exec);
+    bool to_finest = finest.extent(0) > 0;
+    if(to_finest && cg_list.size() == 1){
+        //there is nothing to project, so the initial partition is refined in finest
+        Kokkos::deep_copy(exec, finest, coarse_guess);
+        coarse_guess = finest;
+    }
 
     //this is used for outputting the coarse data for use by another program
     //timing data is reset after dumping for comparison with other program
@@ -98,15 +131,14 @@ static part_vt multilevel_jet(std::list<clt> cg_list, part_vt coarse_guess, cons
             //dumps the hierarchy starting from the coarsest graph that is balanced before refinement
             double imb = 0;
             if(!rfd.init){
-                imb = get_max_imb(stat::get_part_sizes(cg.mtx, cg.vtx_w, coarse_guess, k), k);
+                imb = get_max_imb(stat::get_part_sizes(cg.mtx, cg.vtx_w, coarse_guess, k, exec), k);
             } else {
                 imb = get_max_imb(rfd.part_sizes, k);
             }
             if(imb <= config.max_imb_ratio){
-                binary_dump<matrix_t, part_t>::dump_coarse_part(coarse_guess);
-                binary_dump<matrix_t, part_t>::dump_coarse(cg_list);
+                binary_dump<matrix_t, part_t>::dump_coarse(config.coarse_dump_file, cg_list, coarse_guess);
                 is_dumped = true;
-                Kokkos::fence();
+                exec.fence();
                 t.reset();
             }
         }
@@ -115,8 +147,8 @@ static part_vt multilevel_jet(std::list<clt> cg_list, part_vt coarse_guess, cons
         if(!cg_list.empty()){
             clt next_cg = cg_list.back();
             // project solution onto finer level graph
-            part_vt fine_vec(Kokkos::ViewAllocateWithoutInitializing("fine vec"), next_cg.mtx.numRows());
-            project(next_cg.mtx.numRows(), cg.interp_mtx.map, coarse_guess, fine_vec);
+            part_vt fine_vec = (to_finest && cg_list.size() == 1) ? finest : part_vt(Kokkos::ViewAllocateWithoutInitializing("fine vec"), next_cg.mtx.numRows());
+            project(next_cg.mtx.numRows(), cg.interp_mtx.map, coarse_guess, fine_vec, exec);
             coarse_guess = fine_vec;
         }
     }
@@ -125,12 +157,21 @@ static part_vt multilevel_jet(std::list<clt> cg_list, part_vt coarse_guess, cons
 }
 
 static part_vt uncoarsen(std::list<clt> cg_list, part_vt coarsest, const config_t& config,
-    scalar_t& ec, experiment_data<scalar_t>& experiment) {
+    scalar_t& ec, experiment_data<scalar_t>& experiment, const exec_space& exec = exec_space()) {
+
+    std::unique_ptr<ref_t> refiner;
+    return uncoarsen(cg_list, coarsest, config, ec, experiment, refiner, exec);
+}
+
+//refiner holds the refinement scratch memory and may be kept between calls
+//if finest is non-empty, the partition of the finest level is written into it and returned
+static part_vt uncoarsen(std::list<clt> cg_list, part_vt coarsest, const config_t& config,
+    scalar_t& ec, experiment_data<scalar_t>& experiment, std::unique_ptr<ref_t>& refiner, const exec_space& exec, part_vt finest = part_vt()) {
 
     Kokkos::Timer t;
     rfd_t rfd;
-    part_vt res = multilevel_jet(cg_list, coarsest, config, rfd, experiment, t);
-    Kokkos::fence();
+    part_vt res = multilevel_jet(cg_list, coarsest, config, rfd, experiment, t, refiner, exec, finest);
+    exec.fence();
     double rtime = t.seconds();
     t.reset();
     ec = rfd.cut / 2;
@@ -0,0 +1,93 @@
+// ***********************************************************************
+// 
+// Jet: Multilevel Graph Partitioning
+//
+// Copyright 2023 National Technology & Engineering Solutions of Sandia, LLC
+// (NTESS). 
+// 
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// ************************************************************************
+#include "jet_defs.h"
+#include "edge_list.hpp"
+#include <vector>
+
+using namespace jet_partitioner;
+using builder_t = edge_list_builder<matrix_t>;
+
+//builds a graph from host edge lists and checks every stored weight against expected
+bool check(const char* name, ordinal_t n, const std::vector<ordinal_t>& src, const std::vector<ordinal_t>& dst, const std::vector<value_t>& wgts,
+    duplicate_rule rule, edge_offset_t expected_nnz, value_t expected_weight, bool expected_uniform){
+    vtx_vt s("src", src.size()), d("dst", dst.size());
+    wgt_vt w("wgts", wgts.size());
+    auto s_m = Kokkos::create_mirror_view(s);
+    auto d_m = Kokkos::create_mirror_view(d);
+    auto w_m = Kokkos::create_mirror_view(w);
+    for(size_t i = 0; i < src.size(); i++){
+        s_m(i) = src[i];
+        d_m(i) = dst[i];
+        w_m(i) = wgts[i];
+    }
+    Kokkos::deep_copy(s, s_m);
+    Kokkos::deep_copy(d, d_m);
+    Kokkos::deep_copy(w, w_m);
+    matrix_t g;
+    bool uniform_ew = false;
+    bool ok = builder_t::build(n, s, d, w, rule, g, uniform_ew);
+    ok = ok && g.nnz() == expected_nnz && uniform_ew == expected_uniform;
+    if(ok){
+        auto values = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), g.values);
+        for(edge_offset_t j = 0; j < g.nnz(); j++){
+            if(values(j) != expected_weight) ok = false;
+        }
+    }
+    std::cout << name << ": " << (ok ? "passed" : "FAILED") << std::endl;
+    return ok;
+}
+
+int main(){
+    Kokkos::initialize();
+    bool ok = true;
+    {
+        //a unit weight edge listed in both directions stays a unit weight edge under every rule
+        for(duplicate_rule rule : {duplicate_rule::sum, duplicate_rule::max, duplicate_rule::first}){
+            ok = check("both directions", 3, {0, 1, 1, 2}, {1, 0, 2, 1}, {1, 1, 1, 1}, rule, 4, 1, true) && ok;
+        }
+        //exact repeats are combined by the rule, and the reverse direction does not add to them
+        ok = check("repeats sum", 2, {0, 0, 1}, {1, 1, 0}, {2, 2, 3}, duplicate_rule::sum, 2, 4, false) && ok;
+        ok = check("repeats max", 2, {0, 0, 1}, {1, 1, 0}, {2, 3, 1}, duplicate_rule::max, 2, 3, false) && ok;
+        ok = check("repeats first", 2, {1, 0, 0}, {0, 1, 1}, {1, 5, 2}, duplicate_rule::first, 2, 5, false) && ok;
+        //self loops are dropped
+        ok = check("self loops", 2, {0, 1}, {0, 0}, {1, 1}, duplicate_rule::sum, 2, 1, true) && ok;
+    }
+    Kokkos::finalize();
+    return ok ? 0 : 1;
+}